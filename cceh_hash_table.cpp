@@ -0,0 +1,258 @@
+#include <cassert>
+#include <functional>
+#include <list>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+
+#include "common/macros.h"
+#include "container/hash/cceh_hash_table.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+template <typename K, typename V>
+CCEHHashTable<K, V>::CCEHHashTable(size_t segment_buckets, size_t probe_buckets)
+    : segment_buckets_(segment_buckets), probe_buckets_(probe_buckets) {
+  BUSTUB_ASSERT(segment_buckets_ > 0 && (segment_buckets_ & (segment_buckets_ - 1)) == 0,
+                "segment_buckets must be a power of two");
+  BUSTUB_ASSERT(probe_buckets_ > 0 && probe_buckets_ <= segment_buckets_, "invalid probe window");
+  dir_.push_back(std::make_shared<Segment>(segment_buckets_, 0, 0));
+}
+
+template <typename K, typename V>
+auto CCEHHashTable<K, V>::GetGlobalDepth() const -> int {
+  std::shared_lock lock(dir_latch_);
+  return global_depth_;
+}
+
+template <typename K, typename V>
+auto CCEHHashTable<K, V>::GetLocalDepth(int dir_index) const -> int {
+  std::shared_ptr<Segment> segment;
+  {
+    std::shared_lock lock(dir_latch_);
+    segment = dir_[static_cast<size_t>(dir_index)];
+  }
+  std::shared_lock lock(segment->latch_);
+  return segment->depth_;
+}
+
+template <typename K, typename V>
+auto CCEHHashTable<K, V>::GetNumSegments() const -> int {
+  std::shared_lock lock(dir_latch_);
+  return num_segments_;
+}
+
+template <typename K, typename V>
+auto CCEHHashTable<K, V>::GetSegment(uint64_t hash) const -> std::shared_ptr<Segment> {
+  std::shared_lock lock(dir_latch_);
+  return dir_[hash & ((1ULL << global_depth_) - 1)];
+}
+
+template <typename K, typename V>
+auto CCEHHashTable<K, V>::Locate(const Segment &segment, uint64_t hash, const K &key, size_t *bucket_index,
+                                 size_t *slot) const -> bool {
+  size_t home = BucketOf(hash);
+  for (size_t probe = 0; probe < probe_buckets_; probe++) {
+    size_t b = (home + probe) & (segment_buckets_ - 1);
+    const Bucket &bucket = segment.buckets_[b];
+    for (size_t s = 0; s < SLOTS_PER_BUCKET; s++) {
+      if (bucket.state_[s].load(std::memory_order_acquire) == READY &&
+          bucket.keys_[s].load(std::memory_order_relaxed) == key) {
+        *bucket_index = b;
+        *slot = s;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+template <typename K, typename V>
+auto CCEHHashTable<K, V>::Find(const K &key, V &value) -> bool {
+  uint64_t hash = HashKey(key);
+  while (true) {
+    std::shared_ptr<Segment> segment = GetSegment(hash);
+    std::shared_lock lock(segment->latch_);
+    if (!Owns(*segment, hash)) {
+      continue;  // split after GetSegment; the directory is about to point elsewhere
+    }
+    size_t b;
+    size_t s;
+    if (!Locate(*segment, hash, key, &b, &s)) {
+      return false;
+    }
+    value = segment->buckets_[b].values_[s];
+    return true;
+  }
+}
+
+template <typename K, typename V>
+auto CCEHHashTable<K, V>::Remove(const K &key) -> bool {
+  uint64_t hash = HashKey(key);
+  while (true) {
+    std::shared_ptr<Segment> segment = GetSegment(hash);
+    std::unique_lock lock(segment->latch_);
+    if (!Owns(*segment, hash)) {
+      continue;
+    }
+    size_t b;
+    size_t s;
+    if (!Locate(*segment, hash, key, &b, &s)) {
+      return false;
+    }
+    segment->buckets_[b].state_[s].store(EMPTY, std::memory_order_release);
+    return true;
+  }
+}
+
+template <typename K, typename V>
+void CCEHHashTable<K, V>::Insert(const K &key, const V &value) {
+  uint64_t hash = HashKey(key);
+  while (true) {
+    std::shared_ptr<Segment> segment = GetSegment(hash);
+
+    // 键已存在：在段锁下原地更新值
+    size_t b;
+    size_t s;
+    if (Locate(*segment, hash, key, &b, &s)) {
+      std::unique_lock lock(segment->latch_);
+      if (Owns(*segment, hash) && Locate(*segment, hash, key, &b, &s)) {
+        segment->buckets_[b].values_[s] = value;
+        return;
+      }
+      continue;  // removed or moved by a split in the meantime
+    }
+
+    // 新键：不加锁，用 CAS 抢占空槽
+    int depth = 0;
+    InsertResult result = TryInsertNew(segment.get(), hash, key, value, &depth);
+    if (result == InsertResult::DONE) {
+      return;
+    }
+    if (result == InsertResult::FULL) {
+      SplitSegment(segment, depth);
+    } else {
+      std::this_thread::yield();
+    }
+  }
+}
+
+template <typename K, typename V>
+auto CCEHHashTable<K, V>::TryInsertNew(Segment *segment, uint64_t hash, const K &key, const V &value, int *depth)
+    -> InsertResult {
+  // Announce the insert before checking frozen_; SplitSegment does the opposite, so one of them sees the other
+  segment->writers_.fetch_add(1);
+  if (segment->frozen_.load() || !Owns(*segment, hash)) {
+    segment->writers_.fetch_sub(1);
+    return InsertResult::RETRY;
+  }
+
+  size_t home = BucketOf(hash);
+  size_t window = probe_buckets_ * SLOTS_PER_BUCKET;
+  size_t position = window;
+  for (size_t pos = 0; pos < window && position == window; pos++) {
+    std::atomic<uint8_t> &state = segment->buckets_[(home + pos / SLOTS_PER_BUCKET) & (segment_buckets_ - 1)]
+                                      .state_[pos % SLOTS_PER_BUCKET];
+    uint8_t expected = EMPTY;
+    if (state.load(std::memory_order_relaxed) == EMPTY && state.compare_exchange_strong(expected, CLAIMED)) {
+      position = pos;
+    }
+  }
+  if (position == window) {
+    *depth = segment->depth_;
+    segment->writers_.fetch_sub(1);
+    return InsertResult::FULL;
+  }
+
+  Bucket &bucket = segment->buckets_[(home + position / SLOTS_PER_BUCKET) & (segment_buckets_ - 1)];
+  size_t slot = position % SLOTS_PER_BUCKET;
+  bucket.keys_[slot].store(key, std::memory_order_relaxed);
+  bucket.values_[slot] = value;
+  bucket.state_[slot].store(KEYED);
+
+  // Another thread may be inserting the same key into a different slot of the window. Each inserter stores
+  // KEYED before scanning (both seq_cst), so of two concurrent inserters at least one sees the other. The
+  // lower window position wins and the higher one withdraws; a READY copy always wins.
+  // 低位置的插入者等待高位置的撤回（或在对方先完成扫描时看到它变为 READY 后自己撤回）。
+  InsertResult result = InsertResult::DONE;
+  size_t pos = 0;
+  while (pos < window) {
+    const Bucket &other = segment->buckets_[(home + pos / SLOTS_PER_BUCKET) & (segment_buckets_ - 1)];
+    size_t other_slot = pos % SLOTS_PER_BUCKET;
+    uint8_t state = other.state_[other_slot].load();
+    if (pos == position || (state != KEYED && state != READY) ||
+        !(other.keys_[other_slot].load(std::memory_order_relaxed) == key)) {
+      pos++;
+      continue;
+    }
+    if (state == READY || pos < position) {
+      result = InsertResult::RETRY;
+      break;
+    }
+    // A higher KEYED copy withdraws, or turns READY if it scanned before this slot was KEYED; look again then
+    while (other.state_[other_slot].load() == KEYED) {
+      std::this_thread::yield();
+    }
+  }
+
+  bucket.state_[slot].store(result == InsertResult::DONE ? READY : EMPTY, std::memory_order_release);
+  segment->writers_.fetch_sub(1);
+  return result;
+}
+
+template <typename K, typename V>
+void CCEHHashTable<K, V>::SplitSegment(const std::shared_ptr<Segment> &origin, int depth) {
+  std::unique_lock lock(origin->latch_);
+  if (origin->depth_ != depth) {
+    return;  // another thread split it already
+  }
+  // 冻结段并等待在途的无锁插入结束，之后段内只剩 EMPTY 和 READY 槽
+  origin->frozen_.store(true);
+  while (origin->writers_.load() != 0) {
+    std::this_thread::yield();
+  }
+
+  // The new segment takes every entry whose next hash bit is set. Entries keep their bucket and slot,
+  // which is still inside their probe window because the window only depends on the high hash bits.
+  uint64_t split_bit = 1ULL << origin->depth_;
+  auto divide = std::make_shared<Segment>(segment_buckets_, origin->depth_ + 1, origin->pattern_ | split_bit);
+  for (size_t b = 0; b < segment_buckets_; b++) {
+    Bucket &from = origin->buckets_[b];
+    Bucket &to = divide->buckets_[b];
+    for (size_t s = 0; s < SLOTS_PER_BUCKET; s++) {
+      if (from.state_[s].load(std::memory_order_relaxed) == READY &&
+          (HashKey(from.keys_[s].load(std::memory_order_relaxed)) & split_bit) != 0) {
+        to.keys_[s].store(from.keys_[s].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        to.values_[s] = std::move(from.values_[s]);
+        to.state_[s].store(READY, std::memory_order_relaxed);
+        from.state_[s].store(EMPTY, std::memory_order_relaxed);
+      }
+    }
+  }
+  origin->depth_++;
+
+  {
+    std::unique_lock dir_lock(dir_latch_);
+    if (depth == global_depth_) {
+      size_t primary_dir_len = dir_.size();
+      global_depth_++;
+      for (size_t i = 0; i < primary_dir_len; i++) {
+        dir_.emplace_back(dir_[i]);
+      }
+    }
+    for (size_t i = divide->pattern_; i < dir_.size(); i += split_bit << 1) {
+      dir_[i] = divide;
+    }
+    num_segments_++;
+  }
+  origin->frozen_.store(false);
+}
+
+template class CCEHHashTable<page_id_t, Page *>;
+template class CCEHHashTable<int, int>;
+template class CCEHHashTable<int, std::string>;
+template class CCEHHashTable<int, std::list<int>::iterator>;
+
+}  // namespace bustub
@@ -0,0 +1,199 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// cceh_hash_table.h
+//
+// Identification: src/include/container/hash/cceh_hash_table.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+/**
+ * cceh_hash_table.h
+ *
+ * Implementation of in-memory hash table using cacheline-conscious extendible hashing (CCEH)
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "container/hash/hash_mix.h"
+#include "container/hash/hash_table.h"
+
+namespace bustub {
+
+/**
+ * CCEHHashTable is a three-level variant of ExtendibleHashTable: directory -> segments -> buckets.
+ *
+ * The directory indexes segments instead of buckets. Inside a segment a key hashes to a home bucket
+ * and may live in any of the next `probe_buckets` buckets (a short linear window). Each bucket is sized
+ * to one cache line, so a lookup touches the directory entry plus one or two bucket lines, and the
+ * directory is `segment_buckets` times smaller than one with a pointer per bucket. When a window is
+ * full the whole segment splits; entries keep their slot position so no rehashing inside the
+ * segment is needed.
+ *
+ * Inserting a new key takes no latch: the inserter claims an empty slot with a compare-and-swap, fills
+ * it, and publishes it with a release store of the slot state. Two inserters of the same key resolve
+ * the race between themselves (see TryInsertNew). Updates of an existing key, Remove and splits take
+ * the segment latch exclusively, and Find takes it shared. A split also freezes the segment, so that
+ * latch-free inserters back off and retry once the directory points to the new segments.
+ *
+ * @tparam K key type; stored in an atomic, so it must be trivially copyable
+ * @tparam V value type
+ */
+template <typename K, typename V>
+class CCEHHashTable : public HashTable<K, V> {
+  static_assert(std::is_trivially_copyable_v<K>, "keys are read by latch-free inserters and must be atomic");
+
+ public:
+  /**
+   * @brief Create a new CCEHHashTable.
+   * @param segment_buckets number of buckets per segment, must be a power of two
+   * @param probe_buckets number of consecutive buckets a key may be placed in
+   */
+  explicit CCEHHashTable(size_t segment_buckets = 64, size_t probe_buckets = 4);
+
+  /**
+   * @brief Get the global depth of the directory.
+   * @return The global depth of the directory.
+   */
+  auto GetGlobalDepth() const -> int;
+
+  /**
+   * @brief Get the local depth of the segment that the given directory index points to.
+   * @param dir_index The index in the directory.
+   * @return The local depth of the segment.
+   */
+  auto GetLocalDepth(int dir_index) const -> int;
+
+  /**
+   * @brief Get the number of segments in the directory.
+   * @return The number of segments in the directory.
+   */
+  auto GetNumSegments() const -> int;
+
+  /**
+   * @brief Find the value associated with the given key.
+   * @param key The key to be searched.
+   * @param[out] value The value associated with the key.
+   * @return True if the key is found, false otherwise.
+   */
+  auto Find(const K &key, V &value) -> bool override;
+
+  /**
+   * @brief Insert the given key-value pair into the hash table.
+   * If a key already exists, the value should be updated.
+   * If every bucket in the key's probe window is full, split the segment and retry.
+   * @param key The key to be inserted.
+   * @param value The value to be inserted.
+   */
+  void Insert(const K &key, const V &value) override;
+
+  /**
+   * @brief Given the key, remove the corresponding key-value pair in the hash table.
+   * @param key The key to be deleted.
+   * @return True if the key exists, false otherwise.
+   */
+  auto Remove(const K &key) -> bool override;
+
+ private:
+  static constexpr size_t CACHE_LINE_SIZE = 64;
+
+  static constexpr auto RoundUp(size_t size, size_t align) -> size_t { return (size + align - 1) / align * align; }
+  /** @brief Size of the members of a bucket with the given number of slots, padding included. */
+  static constexpr auto BucketBytes(size_t slots) -> size_t {
+    size_t bytes = RoundUp(slots * sizeof(std::atomic<uint8_t>), alignof(std::atomic<K>));
+    bytes = RoundUp(bytes + slots * sizeof(std::atomic<K>), alignof(V));
+    return bytes + slots * sizeof(V);
+  }
+  /** @brief As many slots as fit in one cache line together with their states, but at least one. */
+  static constexpr auto SlotsPerBucket() -> size_t {
+    size_t slots = 1;
+    while (BucketBytes(slots + 1) <= CACHE_LINE_SIZE) {
+      slots++;
+    }
+    return slots;
+  }
+  static constexpr size_t SLOTS_PER_BUCKET = SlotsPerBucket();
+
+  /** Life cycle of a slot: EMPTY -> CLAIMED (CAS by an inserter) -> KEYED -> READY, and back to EMPTY. */
+  enum SlotState : uint8_t {
+    EMPTY = 0,
+    CLAIMED,  // owned by one inserter, which is writing the key and value
+    KEYED,    // key and value written; the inserter is checking for a concurrent insert of the same key
+    READY,    // visible to Find
+  };
+
+  enum class InsertResult { DONE, FULL, RETRY };
+
+  /** A cache-line-sized group of slots. A zero-initialized bucket has every slot EMPTY. */
+  struct alignas(CACHE_LINE_SIZE) Bucket {
+    std::array<std::atomic<uint8_t>, SLOTS_PER_BUCKET> state_;
+    std::array<std::atomic<K>, SLOTS_PER_BUCKET> keys_;
+    std::array<V, SLOTS_PER_BUCKET> values_;
+  };
+  static_assert(sizeof(Bucket) == CACHE_LINE_SIZE || SLOTS_PER_BUCKET == 1,
+                "a bucket with more than one slot must fill exactly one cache line");
+
+  /** A fixed-size array of buckets that the directory points to. */
+  struct Segment {
+    Segment(size_t num_buckets, int depth, uint64_t pattern)
+        : depth_(depth), pattern_(pattern), buckets_(num_buckets) {}
+    int depth_;
+    uint64_t pattern_;                // the low depth_ hash bits shared by every key in the segment
+    std::shared_mutex latch_;         // shared: Find; exclusive: updates, Remove, split
+    std::atomic<bool> frozen_{false};
+    std::atomic<int> writers_{0};     // latch-free inserters currently inside the segment
+    std::vector<Bucket> buckets_;
+  };
+
+  size_t segment_buckets_;
+  size_t probe_buckets_;
+  int global_depth_{0};
+  int num_segments_{1};
+  mutable std::shared_mutex dir_latch_;  // only held while reading or changing dir_, never while waiting
+  std::vector<std::shared_ptr<Segment>> dir_;
+
+  /** @brief The home bucket of a hash inside its segment; uses bits disjoint from the directory bits. */
+  auto BucketOf(uint64_t hash) const -> size_t { return (hash >> 32) & (segment_buckets_ - 1); }
+
+  /** @brief Get the segment the directory currently maps the hash to. */
+  auto GetSegment(uint64_t hash) const -> std::shared_ptr<Segment>;
+
+  /**
+   * @brief Whether the hash still belongs to the segment, i.e. no split moved it away since GetSegment.
+   * Needs the segment latch, or a writers_ reference on an unfrozen segment.
+   */
+  static auto Owns(const Segment &segment, uint64_t hash) -> bool {
+    return (hash & ((1ULL << segment.depth_) - 1)) == segment.pattern_;
+  }
+
+  /**
+   * @brief Look for a READY slot holding the key in its probe window.
+   * @return true and the position of the slot if found.
+   */
+  auto Locate(const Segment &segment, uint64_t hash, const K &key, size_t *bucket_index, size_t *slot) const -> bool;
+
+  /**
+   * @brief Insert a key that was not found, without taking the segment latch.
+   * @param[out] depth the segment depth seen, when the probe window is full
+   * @return DONE, FULL if the segment must split first, or RETRY if the segment is frozen, no longer
+   * owns the key, or a concurrent insert of the same key won
+   */
+  auto TryInsertNew(Segment *segment, uint64_t hash, const K &key, const V &value, int *depth) -> InsertResult;
+
+  /** @brief Split the segment unless another thread already split it past `depth`. */
+  void SplitSegment(const std::shared_ptr<Segment> &origin, int depth);
+};
+
+}  // namespace bustub
@@ -0,0 +1,219 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// cceh_stress.cpp
+//
+// Identification: tools/cceh_stress/cceh_stress.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+// Concurrency stress test of CCEHHashTable, whose inserts of new keys claim slots with a CAS instead of a latch.
+// The tables use 4-bucket segments with a 2-bucket window, so segments split all the time while the threads run.
+//
+//   same-key: every thread inserts the same keys. Afterwards each key must be stored exactly once, with a value
+//             written by one of the threads: one Remove must leave no copy behind.
+//   mixed:    every key of a small key space is a register owned by one writer, which applies a fixed sequence
+//             of Insert(key, op number) and Remove(key). Inserter threads meanwhile add fresh, disjoint keys that
+//             are never removed, which keeps the segments splitting. Readers check every Find against the
+//             writers: a register read must return the state after one of the operations that overlapped it,
+//             and a fresh key must be found once its inserter has published it.
+//
+// Each check failure prints the offending key and exits with status 1. Run it under TSan and ASan as well.
+//
+// Usage: cceh_stress [threads] [rounds]
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "container/hash/cceh_hash_table.h"
+
+namespace bustub {
+namespace {
+
+using Table = CCEHHashTable<int, int>;
+
+const size_t SEGMENT_BUCKETS = 4;
+const size_t PROBE_BUCKETS = 2;
+
+void Check(bool ok, const char *what, int key) {
+  if (!ok) {
+    std::fprintf(stderr, "FAILED: %s (key %d)\n", what, key);
+    std::exit(1);
+  }
+}
+
+void RunSameKey(int num_threads, int num_keys) {
+  Table table(SEGMENT_BUCKETS, PROBE_BUCKETS);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&table, num_keys, t] {
+      for (int key = 0; key < num_keys; key++) {
+        table.Insert(key, t * num_keys + key);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (int key = 0; key < num_keys; key++) {
+    int value;
+    Check(table.Find(key, value), "inserted key is missing", key);
+    Check(value % num_keys == key && value / num_keys < num_threads, "value was never written", key);
+    Check(table.Remove(key), "Remove missed an inserted key", key);
+    Check(!table.Find(key, value), "key is stored more than once", key);
+    Check(!table.Remove(key), "second Remove found a copy", key);
+  }
+  std::printf("same-key: %d threads x %d keys, %d segments, global depth %d\n", num_threads, num_keys,
+              table.GetNumSegments(), table.GetGlobalDepth());
+}
+
+/**
+ * Operation `op` (from 1) of a register: a Remove or an Insert of the value `op`, decided by a hash of key and op.
+ * The state after an operation depends on that operation alone, so readers can compute it without the writer.
+ */
+auto IsRemove(int key, uint64_t op) -> bool {
+  uint64_t h = (static_cast<uint64_t>(key) << 32 | op) * 0x9E3779B97F4A7C15ULL;
+  return (h >> 61) < 3;  // 3 in 8 operations remove
+}
+
+/** Whether a Find result is the state of the register after operation `op`; op 0 is the empty start. */
+auto MatchesState(int key, uint64_t op, bool found, int value) -> bool {
+  if (op == 0 || IsRemove(key, op)) {
+    return !found;
+  }
+  return found && value == static_cast<int>(op);
+}
+
+void RunMixed(int num_threads, int num_registers, int ops_per_register, int fresh_per_inserter, unsigned seed) {
+  Table table(SEGMENT_BUCKETS, PROBE_BUCKETS);
+  const int num_writers = num_threads;
+  const int num_inserters = num_threads;
+  const int num_readers = num_threads;
+  // completed_[key]: operations of the register that have returned; published with release
+  auto completed = std::make_unique<std::atomic<uint64_t>[]>(num_registers);
+  // published_[t]: fresh keys of inserter t that are in the table
+  auto published = std::make_unique<std::atomic<int>[]>(num_inserters);
+  for (int key = 0; key < num_registers; key++) {
+    completed[key].store(0);
+  }
+  for (int t = 0; t < num_inserters; t++) {
+    published[t].store(0);
+  }
+  // Fresh keys live above the register keys: inserter t owns num_registers + i * num_inserters + t
+  auto fresh_key = [num_registers, num_inserters](int t, int i) { return num_registers + i * num_inserters + t; };
+  std::atomic<int> running{num_writers + num_inserters};
+  std::atomic<uint64_t> register_reads{0};
+  std::atomic<uint64_t> fresh_reads{0};
+
+  std::vector<std::thread> threads;
+  for (int w = 0; w < num_writers; w++) {
+    threads.emplace_back([&, w] {
+      std::vector<bool> present(num_registers, false);
+      for (int round = 0; round < ops_per_register; round++) {
+        for (int key = w; key < num_registers; key += num_writers) {
+          uint64_t op = completed[key].load(std::memory_order_relaxed) + 1;
+          if (IsRemove(key, op)) {
+            // Only this thread changes the key, so Remove must see exactly the state it left
+            Check(table.Remove(key) == present[key], "Remove disagrees with the register state", key);
+            present[key] = false;
+          } else {
+            table.Insert(key, static_cast<int>(op));
+            present[key] = true;
+          }
+          completed[key].store(op, std::memory_order_release);
+        }
+      }
+      running.fetch_sub(1);
+    });
+  }
+  for (int t = 0; t < num_inserters; t++) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < fresh_per_inserter; i++) {
+        table.Insert(fresh_key(t, i), i);
+        published[t].store(i + 1, std::memory_order_release);
+      }
+      running.fetch_sub(1);
+    });
+  }
+  for (int r = 0; r < num_readers; r++) {
+    threads.emplace_back([&, r] {
+      std::mt19937 rng(seed * 131 + r);
+      uint64_t reads = 0;
+      uint64_t fresh = 0;
+      while (running.load() > 0) {
+        int value;
+        if (rng() % 2 == 0) {
+          int key = static_cast<int>(rng() % num_registers);
+          uint64_t before = completed[key].load(std::memory_order_acquire);
+          bool found = table.Find(key, value);
+          uint64_t after = completed[key].load(std::memory_order_acquire);
+          // Operation after + 1 may have taken effect without returning yet
+          bool ok = false;
+          for (uint64_t op = before; op <= after + 1 && !ok; op++) {
+            ok = MatchesState(key, op, found, value);
+          }
+          Check(ok, "register read matches no overlapping operation", key);
+          reads++;
+        } else {
+          int t = static_cast<int>(rng() % num_inserters);
+          int limit = published[t].load(std::memory_order_acquire);
+          if (limit == 0) {
+            continue;
+          }
+          int i = static_cast<int>(rng() % limit);
+          Check(table.Find(fresh_key(t, i), value) && value == i, "published fresh key is missing", fresh_key(t, i));
+          fresh++;
+        }
+      }
+      register_reads.fetch_add(reads);
+      fresh_reads.fetch_add(fresh);
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  for (int key = 0; key < num_registers; key++) {
+    int value;
+    bool found = table.Find(key, value);
+    Check(MatchesState(key, completed[key].load(), found, value), "final register state is wrong", key);
+  }
+  for (int t = 0; t < num_inserters; t++) {
+    for (int i = 0; i < fresh_per_inserter; i++) {
+      int value;
+      Check(table.Find(fresh_key(t, i), value) && value == i, "fresh key is missing at the end", fresh_key(t, i));
+    }
+  }
+  std::printf("mixed: %d writers x %d registers x %d ops, %d inserters x %d keys, %d readers: %lu register and %lu "
+              "fresh reads, %d segments, global depth %d\n",
+              num_writers, num_registers, ops_per_register, num_inserters, fresh_per_inserter, num_readers,
+              static_cast<unsigned long>(register_reads.load()),  // NOLINT
+              static_cast<unsigned long>(fresh_reads.load()),     // NOLINT
+              table.GetNumSegments(), table.GetGlobalDepth());
+}
+
+}  // namespace
+}  // namespace bustub
+
+auto main(int argc, char **argv) -> int {
+  int num_threads = argc > 1 ? std::atoi(argv[1]) : 8;
+  int rounds = argc > 2 ? std::atoi(argv[2]) : 5;
+  if (num_threads <= 0 || rounds <= 0) {
+    std::fprintf(stderr, "usage: %s [threads] [rounds]\n", argv[0]);
+    return 1;
+  }
+  for (int round = 0; round < rounds; round++) {
+    bustub::RunSameKey(num_threads, 20000);
+    bustub::RunMixed(num_threads, 512, 200, 20000, round);
+  }
+  std::printf("ok\n");
+  return 0;
+}
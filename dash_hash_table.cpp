@@ -0,0 +1,278 @@
+#include <functional>
+#include <list>
+#include <mutex>  // NOLINT
+#include <string>
+#include <utility>
+
+#include "common/macros.h"
+#include "container/hash/dash_hash_table.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+template <typename K, typename V>
+DashHashTable<K, V>::DashHashTable(size_t normal_buckets, size_t stash_buckets)
+    : normal_buckets_(normal_buckets), stash_buckets_(stash_buckets) {
+  BUSTUB_ASSERT(normal_buckets_ >= 2 && (normal_buckets_ & (normal_buckets_ - 1)) == 0,
+                "normal_buckets must be a power of two");
+  dir_.push_back(std::make_shared<Segment>(normal_buckets_ + stash_buckets_, 0));
+}
+
+template <typename K, typename V>
+auto DashHashTable<K, V>::GetGlobalDepth() const -> int {
+  std::shared_lock lock(latch_);
+  return global_depth_;
+}
+
+template <typename K, typename V>
+auto DashHashTable<K, V>::GetNumSegments() const -> int {
+  std::shared_lock lock(latch_);
+  return num_segments_;
+}
+
+template <typename K, typename V>
+auto DashHashTable<K, V>::GetLoadFactor() const -> double {
+  std::shared_lock lock(latch_);
+  double capacity = static_cast<double>(num_segments_) * (normal_buckets_ + stash_buckets_) * SLOTS_PER_BUCKET;
+  return static_cast<double>(num_items_.load()) / capacity;
+}
+
+//===--------------------------------------------------------------------===//
+// Bucket
+//===--------------------------------------------------------------------===//
+template <typename K, typename V>
+auto DashHashTable<K, V>::Bucket::FindSlot(uint8_t fp, const K &key) const -> int {
+  for (size_t s = 0; s < SLOTS_PER_BUCKET; s++) {
+    if ((occupied_ & (1U << s)) != 0 && fingerprints_[s] == fp && slots_[s].first == key) {
+      return static_cast<int>(s);
+    }
+  }
+  return -1;
+}
+
+template <typename K, typename V>
+void DashHashTable<K, V>::Bucket::Put(int slot, uint8_t fp, std::pair<K, V> item, bool probing) {
+  slots_[slot] = std::move(item);
+  fingerprints_[slot] = fp;
+  occupied_ |= 1U << slot;
+  if (probing) {
+    probing_ |= 1U << slot;
+  } else {
+    probing_ &= ~(1U << slot);
+  }
+}
+
+//===--------------------------------------------------------------------===//
+// Segment operations
+//===--------------------------------------------------------------------===//
+template <typename K, typename V>
+auto DashHashTable<K, V>::Locate(const Segment &segment, uint64_t hash, const K &key, size_t *bucket,
+                                 int *slot) const -> bool {
+  uint8_t fp = Fingerprint(hash);
+  size_t home = HomeOf(hash);
+  for (size_t b : {home, Next(home)}) {
+    int s = segment.buckets_[b].FindSlot(fp, key);
+    if (s >= 0) {
+      *bucket = b;
+      *slot = s;
+      return true;
+    }
+  }
+  // 只有当主桶记录有溢出时才需要扫描 stash
+  if (segment.buckets_[home].overflow_ == 0) {
+    return false;
+  }
+  for (size_t b = normal_buckets_; b < normal_buckets_ + stash_buckets_; b++) {
+    int s = segment.buckets_[b].FindSlot(fp, key);
+    if (s >= 0) {
+      *bucket = b;
+      *slot = s;
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename K, typename V>
+auto DashHashTable<K, V>::InsertNew(Segment *segment, uint64_t hash, const K &key, const V &value) -> bool {
+  auto &buckets = segment->buckets_;
+  uint8_t fp = Fingerprint(hash);
+  size_t home = HomeOf(hash);
+  size_t next = Next(home);
+
+  // 1. Balanced insert: the emptier of the home bucket and its neighbour
+  Bucket &target = buckets[home].FreeSlots() >= buckets[next].FreeSlots() ? buckets[home] : buckets[next];
+  if (!target.IsFull()) {
+    target.Put(__builtin_ctz(~target.occupied_ & 0xFFU), fp, {key, value}, &target == &buckets[next]);
+    return true;
+  }
+
+  // 2. Displacement: move a resident of the neighbour that is at home there into its own neighbour...
+  size_t after = Next(next);
+  if (!buckets[after].IsFull()) {
+    for (size_t s = 0; s < SLOTS_PER_BUCKET; s++) {
+      if ((buckets[next].probing_ & (1U << s)) == 0) {
+        Bucket &from = buckets[next];
+        buckets[after].Put(__builtin_ctz(~buckets[after].occupied_ & 0xFFU), from.fingerprints_[s],
+                           std::move(from.slots_[s]), true);
+        from.Put(static_cast<int>(s), fp, {key, value}, true);
+        return true;
+      }
+    }
+  }
+  // ... or move a resident of the home bucket that probed from the previous bucket back there
+  size_t before = Prev(home);
+  if (!buckets[before].IsFull()) {
+    for (size_t s = 0; s < SLOTS_PER_BUCKET; s++) {
+      if ((buckets[home].probing_ & (1U << s)) != 0) {
+        Bucket &from = buckets[home];
+        buckets[before].Put(__builtin_ctz(~buckets[before].occupied_ & 0xFFU), from.fingerprints_[s],
+                            std::move(from.slots_[s]), false);
+        from.Put(static_cast<int>(s), fp, {key, value}, false);
+        return true;
+      }
+    }
+  }
+
+  // 3. Stash
+  for (size_t b = normal_buckets_; b < normal_buckets_ + stash_buckets_; b++) {
+    if (!buckets[b].IsFull()) {
+      buckets[b].Put(__builtin_ctz(~buckets[b].occupied_ & 0xFFU), fp, {key, value}, false);
+      buckets[home].overflow_++;
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename K, typename V>
+auto DashHashTable<K, V>::Find(const K &key, V &value) -> bool {
+  uint64_t hash = HashKey(key);
+  std::shared_lock dir_lock(latch_);
+  const Segment &segment = *dir_[hash & ((1ULL << global_depth_) - 1)];
+  std::shared_lock seg_lock(segment.latch_);
+  size_t b;
+  int s;
+  if (!Locate(segment, hash, key, &b, &s)) {
+    return false;
+  }
+  value = segment.buckets_[b].slots_[s].second;
+  return true;
+}
+
+template <typename K, typename V>
+auto DashHashTable<K, V>::Remove(const K &key) -> bool {
+  uint64_t hash = HashKey(key);
+  std::shared_lock dir_lock(latch_);
+  Segment &segment = *dir_[hash & ((1ULL << global_depth_) - 1)];
+  std::unique_lock seg_lock(segment.latch_);
+  size_t b;
+  int s;
+  if (!Locate(segment, hash, key, &b, &s)) {
+    return false;
+  }
+  segment.buckets_[b].occupied_ &= ~(1U << s);
+  if (b >= normal_buckets_) {
+    segment.buckets_[HomeOf(hash)].overflow_--;
+  }
+  num_items_--;
+  return true;
+}
+
+template <typename K, typename V>
+void DashHashTable<K, V>::Insert(const K &key, const V &value) {
+  uint64_t hash = HashKey(key);
+  while (true) {
+    {
+      std::shared_lock dir_lock(latch_);
+      Segment &segment = *dir_[hash & ((1ULL << global_depth_) - 1)];
+      std::unique_lock seg_lock(segment.latch_);
+      size_t b;
+      int s;
+      if (Locate(segment, hash, key, &b, &s)) {
+        segment.buckets_[b].slots_[s].second = value;
+        return;
+      }
+      if (InsertNew(&segment, hash, key, value)) {
+        num_items_++;
+        return;
+      }
+    }
+
+    // 段已满：独占目录锁后分裂。其他线程可能已经腾出空间或完成分裂，因此先重新尝试一次。
+    std::unique_lock dir_lock(latch_);
+    size_t dir_index = hash & ((1ULL << global_depth_) - 1);
+    Segment &segment = *dir_[dir_index];
+    size_t b;
+    int s;
+    if (Locate(segment, hash, key, &b, &s)) {
+      segment.buckets_[b].slots_[s].second = value;
+      return;
+    }
+    if (InsertNew(&segment, hash, key, value)) {
+      num_items_++;
+      return;
+    }
+    SplitSegment(dir_index);
+  }
+}
+
+template <typename K, typename V>
+void DashHashTable<K, V>::SplitSegment(size_t dir_index) {
+  std::shared_ptr<Segment> origin = dir_[dir_index];
+
+  if (origin->depth_ == global_depth_) {
+    size_t primary_dir_len = dir_.size();
+    global_depth_++;
+    for (size_t i = 0; i < primary_dir_len; i++) {
+      dir_.emplace_back(dir_[i]);
+    }
+  }
+
+  // Entries whose next hash bit is set move to the new segment at the same bucket and slot, which keeps
+  // every home/neighbour/stash invariant intact; only the stash overflow counters are recomputed.
+  uint64_t split_bit = 1ULL << origin->depth_;
+  origin->depth_++;
+  auto divide = std::make_shared<Segment>(normal_buckets_ + stash_buckets_, origin->depth_);
+  num_segments_++;
+  num_splits_++;
+
+  for (size_t b = 0; b < normal_buckets_ + stash_buckets_; b++) {
+    Bucket &from = origin->buckets_[b];
+    Bucket &to = divide->buckets_[b];
+    for (size_t s = 0; s < SLOTS_PER_BUCKET; s++) {
+      if ((from.occupied_ & (1U << s)) != 0 && (HashKey(from.slots_[s].first) & split_bit) != 0) {
+        to.Put(static_cast<int>(s), from.fingerprints_[s], std::move(from.slots_[s]), (from.probing_ & (1U << s)) != 0);
+        from.occupied_ &= ~(1U << s);
+      }
+    }
+  }
+  for (auto *segment : {origin.get(), divide.get()}) {
+    for (size_t b = 0; b < normal_buckets_; b++) {
+      segment->buckets_[b].overflow_ = 0;
+    }
+    for (size_t b = normal_buckets_; b < normal_buckets_ + stash_buckets_; b++) {
+      const Bucket &stash = segment->buckets_[b];
+      for (size_t s = 0; s < SLOTS_PER_BUCKET; s++) {
+        if ((stash.occupied_ & (1U << s)) != 0) {
+          segment->buckets_[HomeOf(HashKey(stash.slots_[s].first))].overflow_++;
+        }
+      }
+    }
+  }
+
+  uint64_t local_mask = (split_bit << 1) - 1;
+  uint64_t divide_index = (dir_index & (split_bit - 1)) | split_bit;
+  for (size_t i = 0; i < dir_.size(); i++) {
+    if ((i & local_mask) == divide_index) {
+      dir_[i] = divide;
+    }
+  }
+}
+
+template class DashHashTable<page_id_t, Page *>;
+template class DashHashTable<int, int>;
+template class DashHashTable<int, std::string>;
+template class DashHashTable<int, std::list<int>::iterator>;
+
+}  // namespace bustub
@@ -0,0 +1,162 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// dash_hash_table.h
+//
+// Identification: src/include/container/hash/dash_hash_table.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+/**
+ * dash_hash_table.h
+ *
+ * Implementation of in-memory hash table modelled on Dash (segmented extendible hashing with
+ * fingerprints, balanced insertion, displacement and stash buckets)
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <utility>
+#include <vector>
+
+#include "container/hash/hash_mix.h"
+#include "container/hash/hash_table.h"
+
+namespace bustub {
+
+/**
+ * DashHashTable is a segmented extendible hash table tuned for high load factors.
+ *
+ * - Every slot carries a one-byte fingerprint, so a probe only compares keys whose fingerprint matches.
+ * - A key may live in its home bucket or the next one; a new key goes to the emptier of the two.
+ * - When both are full, one resident is displaced to its own alternative bucket to make room.
+ * - A few stash buckets per segment absorb the remaining overflow before the segment has to split;
+ *   each home bucket counts how many of its keys sit in the stash, so most lookups skip it.
+ *
+ * Readers hold the directory and segment latches in shared mode, so lookups on any segment and
+ * writers on different segments proceed in parallel. Only a split takes the directory latch exclusively.
+ *
+ * @tparam K key type
+ * @tparam V value type
+ */
+template <typename K, typename V>
+class DashHashTable : public HashTable<K, V> {
+ public:
+  /**
+   * @brief Create a new DashHashTable.
+   * @param normal_buckets number of regular buckets per segment, must be a power of two
+   * @param stash_buckets number of stash buckets per segment
+   */
+  explicit DashHashTable(size_t normal_buckets = 64, size_t stash_buckets = 4);
+
+  /**
+   * @brief Get the global depth of the directory.
+   * @return The global depth of the directory.
+   */
+  auto GetGlobalDepth() const -> int;
+
+  /**
+   * @brief Get the number of segments in the directory.
+   * @return The number of segments in the directory.
+   */
+  auto GetNumSegments() const -> int;
+
+  /**
+   * @brief Get the number of segment splits performed so far.
+   * @return The number of splits.
+   */
+  auto GetNumSplits() const -> size_t { return num_splits_.load(); }
+
+  /**
+   * @brief Get the fraction of allocated slots (including stash slots) that hold an entry.
+   * @return The load factor of the table.
+   */
+  auto GetLoadFactor() const -> double;
+
+  /**
+   * @brief Find the value associated with the given key.
+   * @param key The key to be searched.
+   * @param[out] value The value associated with the key.
+   * @return True if the key is found, false otherwise.
+   */
+  auto Find(const K &key, V &value) -> bool override;
+
+  /**
+   * @brief Insert the given key-value pair into the hash table.
+   * If a key already exists, the value should be updated.
+   * A new key tries, in order: balanced insertion into the home or neighbouring bucket, displacement
+   * of a resident, the stash, and finally a segment split followed by a retry.
+   * @param key The key to be inserted.
+   * @param value The value to be inserted.
+   */
+  void Insert(const K &key, const V &value) override;
+
+  /**
+   * @brief Given the key, remove the corresponding key-value pair in the hash table.
+   * @param key The key to be deleted.
+   * @return True if the key exists, false otherwise.
+   */
+  auto Remove(const K &key) -> bool override;
+
+ private:
+  static constexpr size_t SLOTS_PER_BUCKET = 8;
+
+  struct Bucket {
+    uint8_t occupied_{0};  // slot occupancy bitmap
+    uint8_t probing_{0};   // set if the slot's home is the previous bucket
+    uint16_t overflow_{0};  // number of keys homed here that live in the stash
+    std::array<uint8_t, SLOTS_PER_BUCKET> fingerprints_{};
+    std::array<std::pair<K, V>, SLOTS_PER_BUCKET> slots_;
+
+    inline auto IsFull() const -> bool { return occupied_ == 0xFF; }
+    inline auto FreeSlots() const -> int { return static_cast<int>(SLOTS_PER_BUCKET) - __builtin_popcount(occupied_); }
+    auto FindSlot(uint8_t fp, const K &key) const -> int;
+    void Put(int slot, uint8_t fp, std::pair<K, V> item, bool probing);
+  };
+
+  struct Segment {
+    Segment(size_t num_buckets, int depth) : depth_(depth), buckets_(num_buckets) {}
+    int depth_;
+    std::vector<Bucket> buckets_;  // normal buckets followed by stash buckets
+    mutable std::shared_mutex latch_;
+  };
+
+  size_t normal_buckets_;
+  size_t stash_buckets_;
+  int global_depth_{0};
+  int num_segments_{1};
+  std::atomic<size_t> num_items_{0};
+  std::atomic<size_t> num_splits_{0};
+  mutable std::shared_mutex latch_;  // protects the directory
+  std::vector<std::shared_ptr<Segment>> dir_;
+
+  static auto Fingerprint(uint64_t hash) -> uint8_t { return static_cast<uint8_t>(hash >> 56); }
+  auto HomeOf(uint64_t hash) const -> size_t { return (hash >> 32) & (normal_buckets_ - 1); }
+  auto Next(size_t bucket) const -> size_t { return (bucket + 1) & (normal_buckets_ - 1); }
+  auto Prev(size_t bucket) const -> size_t { return (bucket + normal_buckets_ - 1) & (normal_buckets_ - 1); }
+
+  /*****************************************************************
+   * Must hold the segment latch before calling the below functions. *
+   *****************************************************************/
+
+  /**
+   * @brief Locate a key in its home bucket, its neighbour or the stash.
+   * @return the bucket index inside the segment and the slot, or false if absent.
+   */
+  auto Locate(const Segment &segment, uint64_t hash, const K &key, size_t *bucket, int *slot) const -> bool;
+
+  /** @brief Place a new key into the segment; returns false if the segment must split. */
+  auto InsertNew(Segment *segment, uint64_t hash, const K &key, const V &value) -> bool;
+
+  /** @brief Must hold latch_ exclusively. Split the segment at dir_index, doubling the directory if needed. */
+  void SplitSegment(size_t dir_index);
+};
+
+}  // namespace bustub
@@ -0,0 +1,121 @@
+#include "common/epoch_manager.h"
+
+#include <utility>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+auto EpochManager::Instance() -> EpochManager & {
+  static EpochManager instance;
+  return instance;
+}
+
+EpochManager::~EpochManager() {
+  // Only reached at process exit, when no thread can be pinned any more
+  for (auto &record : records_) {
+    for (auto &retired : record.retired_) {
+      retired.deleter_(retired.ptr_);
+    }
+  }
+  for (auto &retired : orphans_) {
+    retired.deleter_(retired.ptr_);
+  }
+}
+
+EpochManager::ThreadHandle::~ThreadHandle() {
+  if (record_ == nullptr) {
+    return;
+  }
+  EpochManager &manager = EpochManager::Instance();
+  {
+    std::scoped_lock<std::mutex> lock(manager.orphan_latch_);
+    for (auto &retired : record_->retired_) {
+      manager.orphans_.push_back(retired);
+    }
+  }
+  record_->retired_.clear();
+  record_->pin_depth_ = 0;
+  record_->epoch_.store(INACTIVE);
+  record_->in_use_.store(false);
+}
+
+auto EpochManager::LocalRecord() -> ThreadRecord & {
+  thread_local ThreadHandle handle;
+  if (handle.record_ != nullptr) {
+    return *handle.record_;
+  }
+  for (auto &record : records_) {
+    bool expected = false;
+    if (!record.in_use_.load() && record.in_use_.compare_exchange_strong(expected, true)) {
+      handle.record_ = &record;
+      return record;
+    }
+  }
+  throw Exception(ExceptionType::OUT_OF_RANGE, "too many threads registered with the epoch manager");
+}
+
+void EpochManager::Pin() {
+  ThreadRecord &record = LocalRecord();
+  if (record.pin_depth_++ > 0) {
+    return;
+  }
+  // Publish the epoch, then re-read it: an advance between the load and the store must not be missed
+  uint64_t epoch = global_epoch_.load();
+  while (true) {
+    record.epoch_.store(epoch);
+    uint64_t current = global_epoch_.load();
+    if (current == epoch) {
+      break;
+    }
+    epoch = current;
+  }
+}
+
+void EpochManager::Unpin() {
+  ThreadRecord &record = LocalRecord();
+  BUSTUB_ASSERT(record.pin_depth_ > 0, "Unpin without Pin");
+  if (--record.pin_depth_ == 0) {
+    record.epoch_.store(INACTIVE);
+  }
+}
+
+void EpochManager::Retire(void *ptr, void (*deleter)(void *)) {
+  ThreadRecord &record = LocalRecord();
+  BUSTUB_ASSERT(record.pin_depth_ > 0, "Retire must be called while pinned");
+  record.retired_.push_back({global_epoch_.load(), ptr, deleter});
+  if (record.retired_.size() % COLLECT_INTERVAL == 0) {
+    TryAdvance();
+    Collect(&record.retired_);
+    std::unique_lock<std::mutex> lock(orphan_latch_, std::try_to_lock);
+    if (lock.owns_lock()) {
+      Collect(&orphans_);
+    }
+  }
+}
+
+void EpochManager::TryAdvance() {
+  uint64_t epoch = global_epoch_.load();
+  for (const auto &record : records_) {
+    uint64_t local = record.epoch_.load();
+    if (local != INACTIVE && local != epoch) {
+      return;
+    }
+  }
+  global_epoch_.compare_exchange_strong(epoch, epoch + 1);
+}
+
+void EpochManager::Collect(std::vector<Retired> *retired) {
+  uint64_t epoch = global_epoch_.load();
+  size_t kept = 0;
+  for (auto &item : *retired) {
+    if (item.epoch_ + 2 <= epoch) {
+      item.deleter_(item.ptr_);
+    } else {
+      (*retired)[kept++] = item;
+    }
+  }
+  retired->resize(kept);
+}
+
+}  // namespace bustub
@@ -0,0 +1,117 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// epoch_manager.h
+//
+// Identification: src/include/common/epoch_manager.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * EpochManager implements epoch-based memory reclamation for lock-free data structures.
+ *
+ * A thread pins the current global epoch for the duration of an operation (see EpochGuard). A node that
+ * has been unlinked is handed to Retire() instead of being deleted, and is only freed once the global
+ * epoch has advanced twice past the epoch it was retired in. The global epoch can only advance when
+ * every pinned thread has observed the current epoch, so by then no thread can still hold a reference.
+ *
+ * The manager is process-wide; threads register lazily on their first Pin() and release their slot when
+ * they exit.
+ */
+class EpochManager {
+ public:
+  /** Maximum number of threads that can be registered at the same time. */
+  static constexpr size_t MAX_THREADS = 256;
+
+  /** @brief Get the process-wide epoch manager. */
+  static auto Instance() -> EpochManager &;
+
+  DISALLOW_COPY_AND_MOVE(EpochManager);
+
+  /**
+   * Pin the calling thread to the current epoch. Pins nest; only the outermost Unpin() releases the epoch.
+   */
+  void Pin();
+
+  /** Release the calling thread's pin. */
+  void Unpin();
+
+  /**
+   * Defer the destruction of an object until no pinned thread can still reference it.
+   * The caller must be pinned and the object must already be unreachable for new readers.
+   *
+   * @param ptr the object to free
+   * @param deleter function that destroys ptr
+   */
+  void Retire(void *ptr, void (*deleter)(void *));
+
+  /** @brief Get the current global epoch. */
+  auto GetEpoch() const -> uint64_t { return global_epoch_.load(); }
+
+ private:
+  static constexpr uint64_t INACTIVE = UINT64_MAX;
+  /** Try to advance the epoch and free retired objects after this many retirements. */
+  static constexpr size_t COLLECT_INTERVAL = 64;
+
+  struct Retired {
+    uint64_t epoch_;
+    void *ptr_;
+    void (*deleter_)(void *);
+  };
+
+  struct alignas(64) ThreadRecord {
+    std::atomic<uint64_t> epoch_{INACTIVE};
+    std::atomic<bool> in_use_{false};
+    size_t pin_depth_{0};
+    std::vector<Retired> retired_;
+  };
+
+  /** Releases a thread's record when the thread exits. */
+  struct ThreadHandle {
+    ThreadRecord *record_{nullptr};
+    ~ThreadHandle();
+  };
+
+  EpochManager() = default;
+  ~EpochManager();
+
+  auto LocalRecord() -> ThreadRecord &;
+  /** @brief Advance the global epoch if every pinned thread has observed it. */
+  void TryAdvance();
+  /** @brief Free every retired object in the list that is at least two epochs old. */
+  void Collect(std::vector<Retired> *retired);
+
+  std::atomic<uint64_t> global_epoch_{0};
+  std::array<ThreadRecord, MAX_THREADS> records_;
+
+  /** Retired objects left behind by exited threads. */
+  std::mutex orphan_latch_;
+  std::vector<Retired> orphans_;
+};
+
+/**
+ * RAII helper that pins the current thread for the lifetime of the guard.
+ */
+class EpochGuard {
+ public:
+  EpochGuard() { EpochManager::Instance().Pin(); }
+  ~EpochGuard() { EpochManager::Instance().Unpin(); }
+  DISALLOW_COPY_AND_MOVE(EpochGuard);
+};
+
+}  // namespace bustub
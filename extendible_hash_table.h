@@ -17,9 +17,16 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <functional>
 #include <list>
 #include <memory>
 #include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
 #include <utility>
 #include <vector>
 
@@ -27,6 +34,18 @@
 
 namespace bustub {
 
+/** Counters of the per-thread hot-key cache of ExtendibleHashTable. */
+struct HotKeyCacheStats {
+  uint64_t hits_{0};    // Find calls answered from the calling thread's cache
+  uint64_t misses_{0};  // Find calls that went to the shared table while the cache was enabled
+
+  /** @brief Fraction of cached-mode Find calls answered from the cache. */
+  auto GetHitRate() const -> double {
+    uint64_t total = hits_ + misses_;
+    return total == 0 ? 0 : static_cast<double>(hits_) / static_cast<double>(total);
+  }
+};
+
 /**
  * ExtendibleHashTable implements a hash table using the extendible hashing algorithm.
  * @tparam K key type
@@ -44,6 +63,9 @@ class ExtendibleHashTable : public HashTable<K, V> {
    */
   explicit ExtendibleHashTable(size_t bucket_size);
 
+  /** Stops the split maintenance thread, if it is running. */
+  ~ExtendibleHashTable() override;
+
   /**
    * @brief Get the global depth of the directory.
    * @return The global depth of the directory.
@@ -105,12 +127,94 @@ class ExtendibleHashTable : public HashTable<K, V> {
    */
   auto Remove(const K &key) -> bool override;
 
+  /**
+   * @brief Insert the key with `init` if it is absent, otherwise fold `init` into the existing value in place.
+   *
+   * Unlike a Find followed by an Insert, the latch is taken once and the value is not copied out and back.
+   *
+   * @param key The key to be upserted.
+   * @param init The value inserted for a new key, and passed to combine for an existing one.
+   * @param combine Called as combine(existing, init) when the key exists.
+   */
+  void Upsert(const K &key, const V &init, const std::function<void(V &, const V &)> &combine);
+
+  /**
+   * @brief Upsert a batch of key-value pairs under a single latch acquisition.
+   * @param items The key-value pairs to be upserted, e.g. one column chunk.
+   * @param combine Called as combine(existing, value) when a key exists.
+   */
+  void UpsertBatch(const std::vector<std::pair<K, V>> &items, const std::function<void(V &, const V &)> &combine);
+
+  /**
+   * @brief Write every bucket and the whole directory to a file, starting a new snapshot chain.
+   *
+   * Keys and values must be arithmetic types or std::string; other types throw NotImplementedException.
+   *
+   * @param path The snapshot file to write.
+   */
+  void SaveSnapshot(const std::string &path);
+
+  /**
+   * @brief Write only the buckets modified since the previous snapshot, plus the directory entries that
+   * changed since then, to a file.
+   *
+   * Falls back to a full snapshot if there is no previous snapshot or the last full snapshot is
+   * `full_snapshot_interval` incremental snapshots old, so that recovery chains stay short.
+   *
+   * @param path The snapshot file to write.
+   * @return True if a full snapshot was written, i.e. a new chain starts at this file.
+   */
+  auto SaveIncrementalSnapshot(const std::string &path) -> bool;
+
+  /**
+   * @brief Replace the contents of the table with a snapshot chain.
+   * @param chain A full snapshot followed by the incremental snapshots taken after it, in order.
+   */
+  void LoadSnapshot(const std::vector<std::string> &chain);
+
+  /** @brief Set how many incremental snapshots may follow a full one before the next full snapshot. */
+  void SetFullSnapshotInterval(size_t interval);
+
+  /** @brief Get the number of buckets modified since the previous snapshot. */
+  auto GetNumDirtyBuckets() const -> size_t;
+
+  /**
+   * @brief Start a background thread that splits buckets once they fill past a high-water mark.
+   *
+   * Insert then almost always finds room in its bucket, and the cost of splits and directory doubling
+   * moves off the foreground path. Does nothing if the thread is already running.
+   *
+   * @param high_water fraction of bucket_size at which a bucket is queued for a split
+   */
+  void StartSplitMaintenance(double high_water = 0.75);
+
+  /** @brief Stop the split maintenance thread and wait for it to exit. */
+  void StopSplitMaintenance();
+
+  /** @brief Get the number of splits Insert had to perform itself because it found a full bucket. */
+  auto GetNumForegroundSplits() const -> size_t;
+
+  /** @brief Get the number of splits performed by the maintenance thread. */
+  auto GetNumBackgroundSplits() const -> size_t;
+
+  /**
+   * @brief Turn the per-thread hot-key cache for Find on or off.
+   *
+   * Each thread keeps a small direct-mapped cache of recently found (key, value, bucket version) entries.
+   * Find checks it before taking latch_; an entry is only used while its bucket's version is unchanged, so
+   * repeated lookups of hot keys (catalog pages, index roots) never write a shared cache line.
+   */
+  void EnableHotKeyCache(bool enable = true);
+
+  /** @brief Get the hit and miss counts of the hot-key cache, summed over all threads. */
+  auto GetHotKeyCacheStats() const -> HotKeyCacheStats;
+
   /**
    * Bucket class for each hash table bucket that the directory points to.
    */
   class Bucket {
    public:
-    explicit Bucket(size_t size, int depth = 0);
+    explicit Bucket(size_t size, int depth = 0, uint64_t id = 0);
 
     /** @brief Check if a bucket is full. */
     inline auto IsFull() const -> bool { return list_.size() == size_; }
@@ -119,10 +223,44 @@ class ExtendibleHashTable : public HashTable<K, V> {
     inline auto GetDepth() const -> int { return depth_; }
 
     /** @brief Increment the local depth of a bucket. */
-    inline void IncrementDepth() { depth_++; }
+    inline void IncrementDepth() {
+      depth_++;
+      MarkModified();
+    }
+
+    /** @brief Get the id of the bucket, stable across snapshots. */
+    inline auto GetId() const -> uint64_t { return id_; }
+
+    /** @brief Check if the bucket was modified since the previous snapshot. */
+    inline auto IsDirty() const -> bool { return dirty_; }
+
+    /** @brief Mark the bucket clean (after a snapshot) or dirty. */
+    inline void SetDirty(bool dirty) { dirty_ = dirty; }
+
+    /** @brief Check if the bucket is waiting in the table's split queue. */
+    inline auto IsSplitQueued() const -> bool { return split_queued_; }
+
+    /** @brief Record that the bucket entered or left the table's split queue. */
+    inline void SetSplitQueued(bool queued) { split_queued_ = queued; }
+
+    /** @brief Record a modification (e.g. after changing a value returned by Lookup): mark dirty, bump version. */
+    inline void MarkModified() {
+      dirty_ = true;
+      version_.fetch_add(1, std::memory_order_release);
+    }
+
+    /** @brief Get the version of the bucket, bumped by every modification. */
+    inline auto GetVersion() const -> uint64_t { return version_.load(std::memory_order_acquire); }
 
     inline auto GetItems() -> std::list<std::pair<K, V>> & { return list_; }
 
+    /**
+     * @brief Get a pointer to the value associated with the given key in the bucket.
+     * @param key The key to be searched.
+     * @return The value stored in the bucket, or nullptr if the key is absent.
+     */
+    auto Lookup(const K &key) -> V *;
+
     /**
      *
      * TODO(P1): Add implementation
@@ -161,6 +299,10 @@ class ExtendibleHashTable : public HashTable<K, V> {
     // TODO(student): You may add additional private members and helper functions
     size_t size_;
     int depth_;
+    uint64_t id_;
+    bool dirty_{true};  // a new bucket has never been written to a snapshot
+    bool split_queued_{false};
+    std::atomic<uint64_t> version_{0};
     std::list<std::pair<K, V>> list_;
   };
 
@@ -174,6 +316,53 @@ class ExtendibleHashTable : public HashTable<K, V> {
   mutable std::mutex latch_;
   std::vector<std::shared_ptr<Bucket>> dir_;  // The directory of the hash table
 
+  uint64_t next_bucket_id_{1};
+  uint64_t snapshot_seq_{0};                // sequence number of the last snapshot, 0 if none
+  size_t full_snapshot_interval_{16};
+  size_t incrementals_since_full_{0};
+  std::vector<uint64_t> snapshot_dir_ids_;  // bucket ids of the directory at the last snapshot
+
+  size_t split_high_water_{0};       // bucket fill that queues a background split, 0 if disabled
+  std::vector<Bucket *> split_queue_;  // buckets at or above the mark, each queued at most once
+  bool stop_maintenance_{false};
+  size_t foreground_splits_{0};
+  size_t background_splits_{0};
+  std::condition_variable maintenance_cv_;
+  std::thread maintenance_thread_;
+
+  static constexpr size_t HOT_KEY_CACHE_SIZE = 64;
+  static constexpr size_t HOT_KEY_COUNTER_SHARDS = 64;
+  static constexpr uint32_t HOT_KEY_MAX_CREDIT = 4;
+
+  /** One slot of a thread's hot-key cache. */
+  struct HotKeyEntry {
+    uint64_t table_id_{0};  // 0 for an empty slot
+    K key_{};
+    V value_{};
+    const Bucket *bucket_{nullptr};  // not owned; only read while table_id_ matches a live table
+    uint64_t version_{0};            // bucket version when the entry was filled
+    uint32_t credit_{0};             // hits minus conflicting misses; the entry is replaced at 0
+  };
+
+  /** A hit counter on its own cache line, so threads counting hits do not share lines. */
+  struct alignas(64) PaddedCounter {
+    std::atomic<uint64_t> value_{0};
+  };
+
+  const uint64_t table_id_;  // distinguishes tables in the thread-local caches; never reused
+  // Buckets dropped by LoadSnapshot, emptied of their items. Hot-key caches may still read their versions
+  // without latch_, so they live as long as the table; splits never free a bucket.
+  std::vector<std::shared_ptr<Bucket>> replaced_buckets_;
+  std::atomic<bool> hot_key_cache_enabled_{false};
+  std::array<PaddedCounter, HOT_KEY_COUNTER_SHARDS> hot_key_hits_;
+  std::atomic<uint64_t> hot_key_misses_{0};
+
+  /** @brief The calling thread's hot-key cache, shared by every table with these K and V. */
+  static auto HotKeyCache() -> std::array<HotKeyEntry, HOT_KEY_CACHE_SIZE> &;
+  auto HotKeySlot(const K &key) const -> size_t;
+  /** @brief The calling thread's hit counter shard. */
+  static auto ThreadShard() -> size_t;
+
   // The following functions are completely optional, you can delete them if you have your own ideas.
 
   /**
@@ -193,6 +382,31 @@ class ExtendibleHashTable : public HashTable<K, V> {
    */
   auto IndexOf(const K &key) -> size_t;
 
+  /**
+   * @brief Insert the given key-value pair, splitting buckets as needed.
+   * @param key The key to be inserted.
+   * @param value The value to be inserted.
+   */
+  void InsertInternal(const K &key, const V &value);
+
+  /** @brief Upsert one key; see Upsert. */
+  void UpsertInternal(const K &key, const V &init, const std::function<void(V &, const V &)> &combine);
+
+  /** @brief Split the bucket the given directory index points to, doubling the directory if needed. */
+  void SplitBucket(size_t index);
+
+  /** @brief Queue the bucket for a background split if it is at or above the mark and not queued yet. */
+  void QueueSplit(Bucket *bucket);
+
+  /** @brief Queue every bucket of the directory that is at or above the mark. */
+  void QueueFullBuckets();
+
+  /** Body of the maintenance thread; takes latch_ itself. */
+  void MaintenanceLoop();
+
+  /** @brief Write a full or incremental snapshot and mark every bucket clean. */
+  void WriteSnapshot(const std::string &path, bool full);
+
   auto GetGlobalDepthInternal() const -> int;
   auto GetLocalDepthInternal(int dir_index) const -> int;
   auto GetNumBucketsInternal() const -> int;
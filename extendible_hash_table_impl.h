@@ -0,0 +1,679 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table_impl.h
+//
+// Identification: src/include/container/hash/extendible_hash_table_impl.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+/**
+ * extendible_hash_table_impl.h
+ *
+ * Template definitions of ExtendibleHashTable. extendible_hash_table.cpp instantiates the container's own
+ * key and value types; a layer that needs another instantiation includes this header in one of its
+ * translation units and instantiates it there.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <thread>  // NOLINT
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+#include "common/exception.h"
+#include "container/hash/extendible_hash_table.h"
+
+namespace bustub {
+
+namespace extendible_hash_detail {
+/** @brief Id for a new table. Defined once in extendible_hash_table.cpp, so ids are never reused. */
+auto NextTableId() -> uint64_t;
+/** @brief Hot-key counter shard for a thread that has none yet. */
+auto NextThreadShard() -> size_t;
+
+inline constexpr uint32_t SNAPSHOT_MAGIC = 0x45485353;  // "SSHE"
+
+/** Snapshot file header, followed by the directory entries and then the buckets. */
+struct SnapshotHeader {
+  uint32_t magic_;
+  uint32_t full_;  // 1 for a full snapshot, 0 for an incremental one
+  uint64_t seq_;   // position in the chain; an incremental snapshot follows seq_ - 1
+  uint64_t bucket_size_;
+  int32_t global_depth_;
+  uint32_t reserved_;
+  uint64_t num_dir_entries_;  // (directory index, bucket id) pairs that follow
+  uint64_t num_buckets_;      // (bucket id, local depth, item count, items) records that follow
+};
+
+template <typename T>
+void WriteField(std::ostream &out, const T &value) {
+  if constexpr (std::is_arithmetic_v<T>) {
+    out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+  } else if constexpr (std::is_same_v<T, std::string>) {
+    uint64_t length = value.size();
+    out.write(reinterpret_cast<const char *>(&length), sizeof(length));
+    out.write(value.data(), static_cast<std::streamsize>(length));
+  } else {
+    throw NotImplementedException("snapshots only support arithmetic and std::string keys and values");
+  }
+}
+
+template <typename T>
+void ReadField(std::istream &in, T &value) {
+  if constexpr (std::is_arithmetic_v<T>) {
+    in.read(reinterpret_cast<char *>(&value), sizeof(T));
+  } else if constexpr (std::is_same_v<T, std::string>) {
+    uint64_t length = 0;
+    in.read(reinterpret_cast<char *>(&length), sizeof(length));
+    value.resize(in ? length : 0);
+    in.read(value.data(), static_cast<std::streamsize>(value.size()));
+  } else {
+    throw NotImplementedException("snapshots only support arithmetic and std::string keys and values");
+  }
+}
+}  // namespace extendible_hash_detail
+
+template <typename K, typename V>
+ExtendibleHashTable<K, V>::ExtendibleHashTable(size_t initial_bucket_size)
+    : global_depth_(0), bucket_size_(initial_bucket_size), table_id_(extendible_hash_detail::NextTableId()) {
+  // 初始化目录，至少包含一个桶
+  dir_.push_back(std::make_shared<Bucket>(bucket_size_, 0, next_bucket_id_++));
+}
+//初始化全局深度为0，桶的大小为 initial_bucket_size。dir_ 是一个目录，最初包含一个桶。
+
+template <typename K, typename V>
+ExtendibleHashTable<K, V>::~ExtendibleHashTable() {
+  StopSplitMaintenance();
+}
+
+template <typename K, typename V>
+auto ExtendibleHashTable<K, V>::IndexOf(const K &key) -> size_t {
+  int mask = (1 << global_depth_) - 1;
+  size_t index = std::hash<K>()(key) & mask;
+  return index;
+}
+//计算给定键 key 在目录中的索引，使用全局深度作为掩码
+
+template <typename K, typename V>
+auto ExtendibleHashTable<K, V>::GetGlobalDepth() const -> int {
+  std::scoped_lock<std::mutex> lock(latch_); 
+  //使用 std::scoped_lock 对 latch_ 进行加锁，确保在多线程环境下对全局深度的安全访问。
+  int depth = GetGlobalDepthInternal();
+  return depth;
+}
+//获取全局深度（global_depth_）
+
+template <typename K, typename V>
+auto ExtendibleHashTable<K, V>::GetGlobalDepthInternal() const -> int {
+  return global_depth_;
+}
+//内部方法，直接返回当前的全局深度 global_depth_。
+
+template <typename K, typename V>
+auto ExtendibleHashTable<K, V>::GetLocalDepth(int dir_index) const -> int {
+  std::scoped_lock<std::mutex> lock(latch_);  
+  int depth = GetLocalDepthInternal(dir_index);
+  return depth;
+}
+//获取指定目录索引 dir_index 对应桶的局部深度
+
+template <typename K, typename V>
+auto ExtendibleHashTable<K, V>::GetLocalDepthInternal(int dir_index) const -> int {
+  size_t index = static_cast<size_t>(dir_index);  
+  auto bucket = dir_[index];//dir_ 是一个容器索引通常是 size_t 类型
+  int depth = bucket->GetDepth();
+  return depth;
+}
+//内部方法，获取指定目录索引的桶的局部深度。
+
+template <typename K, typename V>
+auto ExtendibleHashTable<K, V>::GetNumBuckets() const -> int {
+  std::scoped_lock<std::mutex> lock(latch_);  
+  int num_buckets = GetNumBucketsInternal();
+  return num_buckets;
+}
+//获取当前哈希表中的桶数量。
+
+template <typename K, typename V>
+auto ExtendibleHashTable<K, V>::GetNumBucketsInternal() const -> int {
+  return num_buckets_;
+}
+//内部方法，直接返回当前的桶数量 num_buckets_。
+
+template <typename K, typename V>
+auto ExtendibleHashTable<K, V>::Find(const K &key, V &value) -> bool {
+    bool use_cache = hot_key_cache_enabled_.load(std::memory_order_relaxed);
+    HotKeyEntry *entry = nullptr;
+    if (use_cache) {
+        // 命中线程本地缓存且桶版本未变时直接返回，不碰 latch_ 和任何共享写
+        entry = &HotKeyCache()[HotKeySlot(key)];
+        if (entry->table_id_ == table_id_ && entry->key_ == key && entry->bucket_->GetVersion() == entry->version_) {
+            value = entry->value_;
+            entry->credit_ = std::min<uint32_t>(entry->credit_ + 1, HOT_KEY_MAX_CREDIT);
+            hot_key_hits_[ThreadShard()].value_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    std::scoped_lock<std::mutex> locker(latch_);
+    auto bucket = dir_.at(IndexOf(key));
+    bool found = bucket->Find(key, value);
+    if (use_cache) {
+        hot_key_misses_.fetch_add(1, std::memory_order_relaxed);
+        // 直接映射缓存里冷键会把热键挤掉：命中过的条目先扣减信用，信用耗尽才被替换
+        if (found && entry->table_id_ == table_id_ && entry->key_ == key) {
+            // Same key, but its bucket changed since: refresh the entry and keep the credit it earned
+            entry->value_ = value;
+            entry->bucket_ = bucket.get();
+            entry->version_ = bucket->GetVersion();
+        } else if (found && entry->table_id_ == table_id_ && entry->credit_ > 0) {
+            entry->credit_--;
+        } else if (found) {
+            *entry = {table_id_, key, value, bucket.get(), bucket->GetVersion(), 0};
+        }
+    }
+    return found;
+}
+//在相应的桶中查找键 key，如果找到则返回 true 并通过引用 value 返回对应的值。
+
+template <typename K, typename V>
+void ExtendibleHashTable<K, V>::EnableHotKeyCache(bool enable) {
+    hot_key_cache_enabled_.store(enable, std::memory_order_relaxed);
+}
+
+template <typename K, typename V>
+auto ExtendibleHashTable<K, V>::GetHotKeyCacheStats() const -> HotKeyCacheStats {
+    HotKeyCacheStats stats;
+    for (const auto &counter : hot_key_hits_) {
+        stats.hits_ += counter.value_.load(std::memory_order_relaxed);
+    }
+    stats.misses_ = hot_key_misses_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+template <typename K, typename V>
+auto ExtendibleHashTable<K, V>::HotKeyCache() -> std::array<HotKeyEntry, HOT_KEY_CACHE_SIZE> & {
+    thread_local std::array<HotKeyEntry, HOT_KEY_CACHE_SIZE> cache;
+    return cache;
+}
+
+template <typename K, typename V>
+auto ExtendibleHashTable<K, V>::HotKeySlot(const K &key) const -> size_t {
+    // 混入表 id，避免多张表的热键总落在同一批槽上
+    return (std::hash<K>()(key) ^ (table_id_ * 0x9E3779B97F4A7C15ULL)) & (HOT_KEY_CACHE_SIZE - 1);
+}
+
+template <typename K, typename V>
+auto ExtendibleHashTable<K, V>::ThreadShard() -> size_t {
+    thread_local size_t shard = extendible_hash_detail::NextThreadShard() % HOT_KEY_COUNTER_SHARDS;
+    return shard;
+}
+
+template <typename K, typename V>
+auto ExtendibleHashTable<K, V>::Remove(const K &key) -> bool {
+    std::scoped_lock<std::mutex> locker(latch_);
+    V find_value;
+    if (!dir_.at(IndexOf(key))->Find(key, find_value)) {
+        return false;
+    }
+    dir_.at(IndexOf(key))->Remove(key);
+    return true;
+}
+//先查找键，如果存在则从桶中删除并返回 true。
+
+template <typename K, typename V>
+void ExtendibleHashTable<K, V>::Insert(const K &key, const V &value) {
+    std::scoped_lock<std::mutex> locker(latch_);
+    InsertInternal(key, value);
+}
+
+template <typename K, typename V>
+void ExtendibleHashTable<K, V>::Upsert(const K &key, const V &init,
+                                       const std::function<void(V &, const V &)> &combine) {
+    std::scoped_lock<std::mutex> locker(latch_);
+    UpsertInternal(key, init, combine);
+}
+
+template <typename K, typename V>
+void ExtendibleHashTable<K, V>::UpsertBatch(const std::vector<std::pair<K, V>> &items,
+                                            const std::function<void(V &, const V &)> &combine) {
+    std::scoped_lock<std::mutex> locker(latch_);
+    for (const auto &[key, value] : items) {
+        UpsertInternal(key, value, combine);
+    }
+}
+//整批只加一次锁，适合按列块做聚合。
+
+template <typename K, typename V>
+void ExtendibleHashTable<K, V>::UpsertInternal(const K &key, const V &init,
+                                               const std::function<void(V &, const V &)> &combine) {
+    V *existing = dir_.at(IndexOf(key))->Lookup(key);
+    if (existing != nullptr) {
+        combine(*existing, init);  // 原地合并，不拷出也不拷回
+        dir_.at(IndexOf(key))->MarkModified();
+        return;
+    }
+    InsertInternal(key, init);
+}
+
+template <typename K, typename V>
+void ExtendibleHashTable<K, V>::InsertInternal(const K &key, const V &value) {
+    while (true) {//该循环允许在插入过程中处理可能的桶分裂，直到成功插入数据为止
+        size_t index = IndexOf(key);
+        auto bucket = dir_.at(index);
+        // 通过 IndexOf(key) 计算该键的索引，以确定对应的桶。
+        //bucket 是指向目录中该索引所指向的桶的智能指针。
+        
+        // 尝试插入，如果成功，返回
+        if (bucket->Insert(key, value)) {
+            // 达到高水位的桶交给后台线程提前分裂，前台插入就很少再遇到满桶
+            QueueSplit(bucket.get());
+            return;
+        }
+
+        foreground_splits_++;
+        SplitBucket(index);
+    }
+}
+
+template <typename K, typename V>
+void ExtendibleHashTable<K, V>::SplitBucket(size_t index) {
+    auto bucket = dir_.at(index);
+    // 局部深度等于全局深度时，先把目录翻倍
+    if (bucket->GetDepth() == global_depth_) {
+        int primary_dir_len = dir_.size();  // 扩展前的目录长度
+
+        // 增加全局深度
+        global_depth_++;
+
+        // 新扩展的shared_ptr依次指向原来的桶
+        //primary_dir_len 是扩展前的目录长度，表示当前 dir_ 中桶的数量。
+        for (int i = 0; i < primary_dir_len; i++) {
+            dir_.emplace_back(dir_.at(i));
+        }
+    }
+
+    // 增加当前桶的局部深度
+    bucket->IncrementDepth();
+
+    // 桶分裂
+    int local_mask = (1 << bucket->GetDepth()) - 1;
+    size_t origin_index = index & local_mask;  // 原始桶目录下标
+    size_t divide_index = (origin_index ^ (~local_mask >> 1)) & local_mask;  // 分裂桶目录下标
+    std::shared_ptr<Bucket> origin_bucket = bucket;  // 指向原始桶
+    std::shared_ptr<Bucket> divide_bucket = std::make_shared<Bucket>(bucket_size_, bucket->GetDepth(),
+                                                                            next_bucket_id_++);  // 指向分裂桶
+    num_buckets_++;//增加总桶的数量
+
+    // 数据分裂：把不再属于原始桶的节点直接 splice 到分裂桶，不拷贝整个桶，也不逐个 Remove/Insert
+    auto &origin_items = origin_bucket->GetItems();
+    auto &divide_items = divide_bucket->GetItems();
+    for (auto it = origin_items.begin(); it != origin_items.end();) {
+        auto next = std::next(it);
+        if ((IndexOf(it->first) & local_mask) != origin_index) {
+            divide_items.splice(divide_items.end(), origin_items, it);
+        }
+        it = next;
+    }
+
+    // 目录重映射：指向原始桶的目录项不用动，只需把低 local_depth 位等于 divide_index 的目录项
+    // 指向分裂桶，它们间隔 2^local_depth，不必扫描整个目录
+    for (size_t dir_index = divide_index; dir_index < dir_.size(); dir_index += local_mask + 1) {
+        dir_.at(dir_index) = divide_bucket;
+    }
+
+    // A half that is still above the high-water mark is queued right away, not at its next insert
+    QueueSplit(origin_bucket.get());
+    QueueSplit(divide_bucket.get());
+}
+
+template <typename K, typename V>
+void ExtendibleHashTable<K, V>::QueueSplit(Bucket *bucket) {
+    if (split_high_water_ == 0 || bucket->IsSplitQueued() || bucket->GetItems().size() < split_high_water_) {
+        return;
+    }
+    bucket->SetSplitQueued(true);
+    split_queue_.push_back(bucket);
+    maintenance_cv_.notify_one();
+}
+
+template <typename K, typename V>
+void ExtendibleHashTable<K, V>::QueueFullBuckets() {
+    for (size_t i = 0; i < dir_.size(); i++) {
+        if (i < (size_t{1} << dir_[i]->GetDepth())) {
+            QueueSplit(dir_[i].get());
+        }
+    }
+}
+
+template <typename K, typename V>
+void ExtendibleHashTable<K, V>::StartSplitMaintenance(double high_water) {
+    std::scoped_lock<std::mutex> locker(latch_);
+    if (maintenance_thread_.joinable()) {
+        return;
+    }
+    split_high_water_ = std::max<size_t>(1, static_cast<size_t>(high_water * static_cast<double>(bucket_size_)));
+    stop_maintenance_ = false;
+    // 已经在高水位之上的桶不会再“越过”它，启动时扫一遍目录把它们都排上队
+    QueueFullBuckets();
+    maintenance_thread_ = std::thread(&ExtendibleHashTable::MaintenanceLoop, this);
+}
+
+template <typename K, typename V>
+void ExtendibleHashTable<K, V>::StopSplitMaintenance() {
+    {
+        std::scoped_lock<std::mutex> locker(latch_);
+        if (!maintenance_thread_.joinable()) {
+            return;
+        }
+        stop_maintenance_ = true;
+        split_high_water_ = 0;
+        for (Bucket *bucket : split_queue_) {
+            bucket->SetSplitQueued(false);
+        }
+        split_queue_.clear();
+    }
+    maintenance_cv_.notify_one();
+    maintenance_thread_.join();
+}
+
+template <typename K, typename V>
+auto ExtendibleHashTable<K, V>::GetNumForegroundSplits() const -> size_t {
+    std::scoped_lock<std::mutex> locker(latch_);
+    return foreground_splits_;
+}
+
+template <typename K, typename V>
+auto ExtendibleHashTable<K, V>::GetNumBackgroundSplits() const -> size_t {
+    std::scoped_lock<std::mutex> locker(latch_);
+    return background_splits_;
+}
+
+template <typename K, typename V>
+void ExtendibleHashTable<K, V>::MaintenanceLoop() {
+    std::unique_lock<std::mutex> lock(latch_);
+    while (true) {
+        maintenance_cv_.wait(lock, [&] { return stop_maintenance_ || !split_queue_.empty(); });
+        if (stop_maintenance_) {
+            return;
+        }
+        Bucket *bucket = split_queue_.back();
+        split_queue_.pop_back();
+        bucket->SetSplitQueued(false);
+        // A queued bucket may have been split by Insert or drained by Remove since; skip it then
+        if (bucket->GetItems().size() < split_high_water_) {
+            continue;
+        }
+        // Any key of the bucket leads back to a directory index that points to it
+        SplitBucket(IndexOf(bucket->GetItems().front().first));
+        background_splits_++;
+        // 每次分裂后放开锁，让前台操作插进来，而不是一口气处理完整个队列
+        lock.unlock();
+        std::this_thread::yield();
+        lock.lock();
+    }
+}
+
+template <typename K, typename V>
+void ExtendibleHashTable<K, V>::SaveSnapshot(const std::string &path) {
+    std::scoped_lock<std::mutex> locker(latch_);
+    WriteSnapshot(path, true);
+    incrementals_since_full_ = 0;
+}
+
+template <typename K, typename V>
+auto ExtendibleHashTable<K, V>::SaveIncrementalSnapshot(const std::string &path) -> bool {
+    std::scoped_lock<std::mutex> locker(latch_);
+    // 没有基准快照，或增量链已经太长时，改写全量快照
+    bool full = snapshot_seq_ == 0 || incrementals_since_full_ >= full_snapshot_interval_;
+    WriteSnapshot(path, full);
+    incrementals_since_full_ = full ? 0 : incrementals_since_full_ + 1;
+    return full;
+}
+
+template <typename K, typename V>
+void ExtendibleHashTable<K, V>::SetFullSnapshotInterval(size_t interval) {
+    std::scoped_lock<std::mutex> locker(latch_);
+    full_snapshot_interval_ = interval;
+}
+
+template <typename K, typename V>
+auto ExtendibleHashTable<K, V>::GetNumDirtyBuckets() const -> size_t {
+    std::scoped_lock<std::mutex> locker(latch_);
+    size_t dirty = 0;
+    for (size_t i = 0; i < dir_.size(); i++) {
+        // 一个局部深度为 d 的桶第一次出现在下标 i < 2^d 处，借此每个桶只数一次
+        if (i < (size_t{1} << dir_[i]->GetDepth()) && dir_[i]->IsDirty()) {
+            dirty++;
+        }
+    }
+    return dirty;
+}
+
+template <typename K, typename V>
+void ExtendibleHashTable<K, V>::WriteSnapshot(const std::string &path, bool full) {
+    std::vector<uint64_t> dir_ids(dir_.size());
+    std::vector<std::pair<uint64_t, uint64_t>> dir_entries;
+    std::vector<std::shared_ptr<Bucket>> buckets;
+    for (size_t i = 0; i < dir_.size(); i++) {
+        dir_ids[i] = dir_[i]->GetId();
+        // 目录增量：只记录与上次快照相比指向了不同桶的目录项（目录只增不减）
+        if (full || i >= snapshot_dir_ids_.size() || snapshot_dir_ids_[i] != dir_ids[i]) {
+            dir_entries.emplace_back(i, dir_ids[i]);
+        }
+        if (i < (size_t{1} << dir_[i]->GetDepth()) && (full || dir_[i]->IsDirty())) {
+            buckets.push_back(dir_[i]);
+        }
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw Exception("can't open snapshot file " + path);
+    }
+    extendible_hash_detail::SnapshotHeader header{};
+    header.magic_ = extendible_hash_detail::SNAPSHOT_MAGIC;
+    header.full_ = full ? 1 : 0;
+    header.seq_ = snapshot_seq_ + 1;
+    header.bucket_size_ = bucket_size_;
+    header.global_depth_ = global_depth_;
+    header.num_dir_entries_ = dir_entries.size();
+    header.num_buckets_ = buckets.size();
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    for (const auto &[index, id] : dir_entries) {
+        extendible_hash_detail::WriteField(out, index);
+        extendible_hash_detail::WriteField(out, id);
+    }
+    for (const auto &bucket : buckets) {
+        extendible_hash_detail::WriteField(out, bucket->GetId());
+        extendible_hash_detail::WriteField(out, bucket->GetDepth());
+        extendible_hash_detail::WriteField(out, static_cast<uint64_t>(bucket->GetItems().size()));
+        for (const auto &[k, v] : bucket->GetItems()) {
+            extendible_hash_detail::WriteField(out, k);
+            extendible_hash_detail::WriteField(out, v);
+        }
+    }
+    out.flush();
+    if (!out) {
+        throw Exception("failed to write snapshot file " + path);
+    }
+
+    // Only clear the dirty state once the file is complete, so a failed snapshot is simply retried
+    for (const auto &bucket : dir_) {
+        bucket->SetDirty(false);
+    }
+    snapshot_dir_ids_ = std::move(dir_ids);
+    snapshot_seq_++;
+}
+
+template <typename K, typename V>
+void ExtendibleHashTable<K, V>::LoadSnapshot(const std::vector<std::string> &chain) {
+    if (chain.empty()) {
+        throw Exception("empty snapshot chain");
+    }
+    // 先在局部变量中合并整条链，出错时哈希表保持原样
+    std::unordered_map<uint64_t, std::shared_ptr<Bucket>> buckets;
+    std::vector<uint64_t> dir_ids;
+    extendible_hash_detail::SnapshotHeader header{};
+    uint64_t seq = 0;
+    for (size_t n = 0; n < chain.size(); n++) {
+        std::ifstream in(chain[n], std::ios::binary);
+        if (!in) {
+            throw Exception("can't open snapshot file " + chain[n]);
+        }
+        in.read(reinterpret_cast<char *>(&header), sizeof(header));
+        if (!in || header.magic_ != extendible_hash_detail::SNAPSHOT_MAGIC) {
+            throw Exception(chain[n] + " is not a hash table snapshot");
+        }
+        if ((n == 0) != (header.full_ == 1) || (n > 0 && header.seq_ != seq + 1)) {
+            throw Exception("snapshot chain is broken at " + chain[n]);
+        }
+        seq = header.seq_;
+        dir_ids.resize(size_t{1} << header.global_depth_);
+        for (uint64_t i = 0; i < header.num_dir_entries_; i++) {
+            uint64_t index = 0;
+            uint64_t id = 0;
+            extendible_hash_detail::ReadField(in, index);
+            extendible_hash_detail::ReadField(in, id);
+            if (index >= dir_ids.size()) {
+                throw Exception("corrupt directory entry in " + chain[n]);
+            }
+            dir_ids[index] = id;
+        }
+        for (uint64_t i = 0; i < header.num_buckets_; i++) {
+            uint64_t id = 0;
+            int depth = 0;
+            uint64_t count = 0;
+            extendible_hash_detail::ReadField(in, id);
+            extendible_hash_detail::ReadField(in, depth);
+            extendible_hash_detail::ReadField(in, count);
+            // A bucket in a later snapshot replaces its older image entirely
+            auto bucket = std::make_shared<Bucket>(header.bucket_size_, depth, id);
+            for (uint64_t j = 0; j < count && in; j++) {
+                K k;
+                V v;
+                extendible_hash_detail::ReadField(in, k);
+                extendible_hash_detail::ReadField(in, v);
+                bucket->GetItems().emplace_back(std::move(k), std::move(v));
+            }
+            buckets[id] = std::move(bucket);
+        }
+        if (!in) {
+            throw Exception("snapshot file " + chain[n] + " is truncated");
+        }
+    }
+
+    std::vector<std::shared_ptr<Bucket>> dir(dir_ids.size());
+    uint64_t max_id = 0;
+    int num_buckets = 0;
+    for (size_t i = 0; i < dir_ids.size(); i++) {
+        auto it = buckets.find(dir_ids[i]);
+        if (it == buckets.end()) {
+            throw Exception("snapshot chain references a missing bucket");
+        }
+        dir[i] = it->second;
+        dir[i]->SetDirty(false);
+        max_id = std::max(max_id, dir_ids[i]);
+        num_buckets += i < (size_t{1} << dir[i]->GetDepth()) ? 1 : 0;
+    }
+
+    std::scoped_lock<std::mutex> locker(latch_);
+    split_queue_.clear();
+    // The replaced buckets may still sit in hot-key caches; bump their versions so those entries miss
+    for (size_t i = 0; i < dir_.size(); i++) {
+        if (i < (size_t{1} << dir_[i]->GetDepth())) {
+            dir_[i]->MarkModified();
+            // 缓存只读版本号，保留一个空桶即可，不必让整份旧数据常驻内存
+            std::list<std::pair<K, V>>().swap(dir_[i]->GetItems());
+            replaced_buckets_.push_back(dir_[i]);
+        }
+    }
+    dir_ = std::move(dir);
+    global_depth_ = header.global_depth_;
+    bucket_size_ = header.bucket_size_;
+    num_buckets_ = num_buckets;
+    next_bucket_id_ = max_id + 1;
+    snapshot_seq_ = seq;
+    snapshot_dir_ids_ = std::move(dir_ids);
+    incrementals_since_full_ = chain.size() - 1;
+    QueueFullBuckets();
+}
+
+
+
+
+//===--------------------------------------------------------------------===//
+// Bucket
+//===--------------------------------------------------------------------===//
+template <typename K, typename V>
+ExtendibleHashTable<K, V>::Bucket::Bucket(size_t array_size, int depth, uint64_t id)
+    : size_(array_size), depth_(depth), id_(id) {}
+
+template <typename K, typename V>
+auto ExtendibleHashTable<K, V>::Bucket::Find(const K &key, V &value) -> bool {
+  for (const auto &item : list_) {
+    if (item.first == key) { 
+      value = item.second;    
+      return true;
+    }
+  }
+  return false;
+}
+//在桶中查找给定的键 key，如果找到，则将对应的值赋给 value，并返回 true；如果未找到，则返回 false。
+
+template <typename K, typename V>
+auto ExtendibleHashTable<K, V>::Bucket::Remove(const K &key) -> bool {
+  auto it = list_.begin();
+  while (it != list_.end()) {
+    if (it->first == key) {
+      list_.erase(it);
+      MarkModified();
+      return true;
+    }
+    ++it;
+  }
+  return false;  
+}
+//从桶中删除指定的键 key，如果成功删除，返回 true；如果未找到该键，则返回 false。
+
+template <typename K, typename V>
+auto ExtendibleHashTable<K, V>::Bucket::Insert(const K &key, const V &value) -> bool {
+  for (auto &pair : list_) {
+    if (pair.first == key) {
+      pair.second = value;
+      MarkModified();
+      return true;  
+    }
+  }
+  if (IsFull()) {
+    return false;  
+  }
+  list_.emplace_back(key, value);
+  MarkModified();
+  return true;
+}
+//向桶中插入一个键值对。如果键已存在，则更新其值；如果桶已满，返回 false。
+
+template <typename K, typename V>
+auto ExtendibleHashTable<K, V>::Bucket::Lookup(const K &key) -> V * {
+  for (auto &item : list_) {
+    if (item.first == key) {
+      return &item.second;
+    }
+  }
+  return nullptr;
+}
+//返回桶中键对应值的指针，不存在则返回 nullptr，供 Upsert 原地修改。
+
+}  // namespace bustub
@@ -0,0 +1,51 @@
+#include <list>
+
+#include "common/macros.h"
+#include "container/hash/frame_indexed_table.h"
+
+namespace bustub {
+
+template <typename V>
+FrameIndexedTable<V>::FrameIndexedTable(Page *frames, size_t num_frames)
+    : frames_(frames), num_frames_(num_frames), values_(num_frames), present_(num_frames, 0) {}
+
+template <typename V>
+auto FrameIndexedTable<V>::FrameIndexOf(Page *page) const -> size_t {
+  BUSTUB_ASSERT(page >= frames_ && page < frames_ + num_frames_, "page is not inside the frame array");
+  return static_cast<size_t>(page - frames_);
+}
+//指针相减即为帧下标，无需哈希。
+
+template <typename V>
+auto FrameIndexedTable<V>::Find(Page *const &key, V &value) -> bool {
+  std::scoped_lock<std::mutex> locker(latch_);
+  size_t index = FrameIndexOf(key);
+  if (present_[index] == 0) {
+    return false;
+  }
+  value = values_[index];
+  return true;
+}
+
+template <typename V>
+void FrameIndexedTable<V>::Insert(Page *const &key, const V &value) {
+  std::scoped_lock<std::mutex> locker(latch_);
+  size_t index = FrameIndexOf(key);
+  values_[index] = value;
+  present_[index] = 1;
+}
+
+template <typename V>
+auto FrameIndexedTable<V>::Remove(Page *const &key) -> bool {
+  std::scoped_lock<std::mutex> locker(latch_);
+  size_t index = FrameIndexOf(key);
+  if (present_[index] == 0) {
+    return false;
+  }
+  present_[index] = 0;
+  return true;
+}
+
+template class FrameIndexedTable<std::list<Page *>::iterator>;
+
+}  // namespace bustub
@@ -0,0 +1,88 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_indexed_table.h
+//
+// Identification: src/include/container/hash/frame_indexed_table.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+/**
+ * frame_indexed_table.h
+ *
+ * Per-frame side array keyed by a frame's position in the buffer pool.
+ */
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "common/config.h"
+#include "container/hash/hash_table.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * FrameIndexedTable stores per-frame metadata for pages that live in one contiguous frame array.
+ *
+ * Hashing a Page * is a poor fit: std::hash on a pointer is the address itself, whose low bits are
+ * constant because of alignment, so extendible hashing masks mostly identical bits. Since every
+ * Page * handed out by the buffer pool points into the same array, (page - frames) is already a
+ * dense, collision-free index and the table degenerates to a plain vector lookup.
+ *
+ * @tparam V value type
+ */
+template <typename V>
+class FrameIndexedTable : public HashTable<Page *, V> {
+ public:
+  /**
+   * @brief Create a new FrameIndexedTable.
+   * @param frames base of the buffer pool's frame array
+   * @param num_frames number of frames in the array
+   */
+  FrameIndexedTable(Page *frames, size_t num_frames);
+
+  /**
+   * @brief Find the value associated with the given frame.
+   * @param key A page inside the frame array.
+   * @param[out] value The value associated with the frame.
+   * @return True if the frame has a value, false otherwise.
+   */
+  auto Find(Page *const &key, V &value) -> bool override;
+
+  /**
+   * @brief Set the value of the given frame, overwriting any previous value.
+   * @param key A page inside the frame array.
+   * @param value The value to be stored.
+   */
+  void Insert(Page *const &key, const V &value) override;
+
+  /**
+   * @brief Clear the value of the given frame.
+   * @param key A page inside the frame array.
+   * @return True if the frame had a value, false otherwise.
+   */
+  auto Remove(Page *const &key) -> bool override;
+
+  /**
+   * @brief Get the frame index of a page inside the frame array.
+   * @param page A page inside the frame array.
+   * @return The position of the page in the frame array.
+   */
+  auto FrameIndexOf(Page *page) const -> size_t;
+
+ private:
+  Page *frames_;
+  size_t num_frames_;
+  std::mutex latch_;
+  std::vector<V> values_;
+  // Not std::vector<bool>: a byte per frame avoids the proxy reference and the read-modify-write of bits shared
+  // with neighbouring frames
+  std::vector<char> present_;
+};
+
+}  // namespace bustub
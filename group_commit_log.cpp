@@ -0,0 +1,176 @@
+#include "recovery/group_commit_log.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#include "common/crc32.h"
+#include "common/exception.h"
+
+namespace bustub {
+
+GroupCommitLog::GroupCommitLog(const std::string &path, std::chrono::microseconds commit_window, size_t max_batch)
+    : commit_window_(commit_window), max_batch_(max_batch) {
+  fd_ = open(path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+  if (fd_ < 0) {
+    throw Exception("can't open log file " + path + ": " + std::string(strerror(errno)));
+  }
+  lsn_t last_lsn = ScanLog();
+  next_lsn_ = last_lsn + 1;
+  persistent_lsn_.store(last_lsn);
+  flush_thread_ = std::thread(&GroupCommitLog::FlushLoop, this);
+}
+
+GroupCommitLog::~GroupCommitLog() {
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    stop_ = true;
+  }
+  flush_cv_.notify_one();
+  flush_thread_.join();
+  close(fd_);
+}
+
+auto GroupCommitLog::Append(HashIndexLogType type, page_id_t page_id, const char *data, size_t size) -> lsn_t {
+  std::unique_lock<std::mutex> lock(latch_);
+  if (!flush_error_.empty()) {
+    throw Exception(flush_error_);
+  }
+  LogRecordHeader header{0, static_cast<uint32_t>(sizeof(LogRecordHeader) + size), next_lsn_++, type, page_id};
+  // The checksum covers everything after the crc field itself
+  header.crc_ = Crc32(reinterpret_cast<const char *>(&header) + sizeof(uint32_t), sizeof(header) - sizeof(uint32_t));
+  header.crc_ = Crc32(data, size, header.crc_);
+  buffer_.append(reinterpret_cast<const char *>(&header), sizeof(header));
+  buffer_.append(data, size);
+  if (++buffered_records_ >= max_batch_) {
+    lock.unlock();
+    flush_cv_.notify_one();
+  }
+  return header.lsn_;
+}
+
+void GroupCommitLog::WaitDurable(lsn_t lsn) {
+  if (IsDurable(lsn)) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(latch_);
+  if (!flush_error_.empty()) {
+    throw Exception(flush_error_);
+  }
+  if (lsn >= next_lsn_) {
+    // Nothing could ever make it durable, so the caller would wait forever
+    throw Exception("log record " + std::to_string(lsn) + " has not been appended");
+  }
+  if (lsn > requested_lsn_) {
+    requested_lsn_ = lsn;
+    flush_cv_.notify_one();
+  }
+  durable_cv_.wait(lock, [&] { return IsDurable(lsn) || !flush_error_.empty(); });
+  if (!IsDurable(lsn)) {
+    throw Exception(flush_error_);
+  }
+}
+
+auto GroupCommitLog::GetStats() const -> GroupCommitStats {
+  GroupCommitStats stats;
+  stats.records_ = records_.load();
+  stats.fsyncs_ = fsyncs_.load();
+  return stats;
+}
+
+auto GroupCommitLog::ScanLog() -> lsn_t {
+  off_t file_size = lseek(fd_, 0, SEEK_END);
+  if (file_size < 0) {
+    throw Exception("can't read log file: " + std::string(strerror(errno)));
+  }
+  lsn_t last_lsn = INVALID_LSN;
+  off_t offset = 0;
+  std::string record;
+  while (offset < file_size) {
+    LogRecordHeader header;
+    if (file_size - offset < static_cast<off_t>(sizeof(header)) ||
+        pread(fd_, &header, sizeof(header), offset) != static_cast<ssize_t>(sizeof(header)) ||
+        header.size_ < sizeof(header) || header.size_ > file_size - offset ||
+        (last_lsn != INVALID_LSN && header.lsn_ != last_lsn + 1)) {
+      break;
+    }
+    // An intact header says nothing about the payload of a torn write
+    record.resize(header.size_);
+    if (pread(fd_, record.data(), record.size(), offset) != static_cast<ssize_t>(record.size()) ||
+        Crc32(record.data() + sizeof(uint32_t), record.size() - sizeof(uint32_t)) != header.crc_) {
+      break;
+    }
+    last_lsn = header.lsn_;
+    offset += header.size_;
+  }
+  // 截掉崩溃时写了一半的记录，否则新记录会追加在残缺数据之后
+  if (offset < file_size && ftruncate(fd_, offset) != 0) {
+    throw Exception("can't truncate log file: " + std::string(strerror(errno)));
+  }
+  // What an earlier process wrote may still be only in the page cache
+  if (last_lsn != INVALID_LSN && fdatasync(fd_) != 0) {
+    throw Exception("failed to sync log file: " + std::string(strerror(errno)));
+  }
+  return last_lsn;
+}
+
+void GroupCommitLog::FlushLoop() {
+  std::string batch;
+  std::unique_lock<std::mutex> lock(latch_);
+  while (true) {
+    flush_cv_.wait(lock, [&] {
+      return stop_ || requested_lsn_ > persistent_lsn_.load() || buffered_records_ >= max_batch_;
+    });
+    // 组提交：第一个等待者到来后再等一个窗口，让更多并发操作搭上同一次 fsync
+    if (!stop_ && buffered_records_ < max_batch_) {
+      flush_cv_.wait_for(lock, commit_window_, [&] { return stop_ || buffered_records_ >= max_batch_; });
+    }
+    if (buffer_.empty()) {
+      if (stop_) {
+        break;
+      }
+      continue;
+    }
+
+    batch.swap(buffer_);
+    size_t records = buffered_records_;
+    buffered_records_ = 0;
+    lsn_t last_lsn = next_lsn_ - 1;
+    lock.unlock();
+
+    // Appends continue into the fresh buffer while this batch is written
+    std::string error;
+    size_t done = 0;
+    while (done < batch.size() && error.empty()) {
+      ssize_t n = write(fd_, batch.data() + done, batch.size() - done);
+      if (n < 0 && errno != EINTR) {
+        error = "failed to write log file: " + std::string(strerror(errno));
+      } else if (n > 0) {
+        done += static_cast<size_t>(n);
+      }
+    }
+    // The kernel may have dropped the pages of a failed sync, so the batch must never be reported durable
+    if (error.empty() && fdatasync(fd_) != 0) {
+      error = "failed to sync log file: " + std::string(strerror(errno));
+    }
+    if (!error.empty()) {
+      // 日志已不可信：停止刷盘，让所有等待者和之后的调用都收到这个错误
+      lock.lock();
+      flush_error_ = std::move(error);
+      durable_cv_.notify_all();
+      return;
+    }
+    batch.clear();
+    records_ += records;
+    fsyncs_++;
+
+    lock.lock();
+    persistent_lsn_.store(last_lsn);
+    durable_cv_.notify_all();
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,142 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// group_commit_log.h
+//
+// Identification: src/include/recovery/group_commit_log.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/** Kinds of page changes logged for a persistent hash index. */
+enum class HashIndexLogType : uint32_t {
+  INVALID = 0,
+  BUCKET_INSERT,     // a key-value pair was added to (or updated in) a bucket page
+  BUCKET_REMOVE,     // a key was removed from a bucket page
+  BUCKET_SPLIT,      // a bucket page was split into a new bucket page
+  DIRECTORY_UPDATE,  // directory page changed (global depth, local depths or bucket page ids)
+};
+
+/** Counters exposed by GroupCommitLog. */
+struct GroupCommitStats {
+  uint64_t records_{0};  // records made durable
+  uint64_t fsyncs_{0};   // fsync calls issued
+
+  /** @brief Average number of records each fsync made durable. */
+  auto GetAverageBatchSize() const -> double {
+    return fsyncs_ == 0 ? 0 : static_cast<double>(records_) / static_cast<double>(fsyncs_);
+  }
+};
+
+/**
+ * GroupCommitLog is a write-ahead log for bucket and directory page changes of a persistent hash index.
+ *
+ * Append() only copies the record into an in-memory buffer and assigns it an LSN. A background flush thread
+ * writes the buffer and issues one fsync for everything appended so far, so many concurrent operations
+ * that call WaitDurable() share a single fsync. After the first waiter arrives the flusher lingers for
+ * up to `commit_window` (or until `max_batch` records are buffered) to let more operations join the batch.
+ *
+ * A failed write or fsync is fatal to the log: the flusher stops, and every WaitDurable() waiting at that
+ * point, and every later Append() or WaitDurable(), throws an Exception carrying the error.
+ *
+ * WAL rule for the buffer pool: a dirty page stamped with page LSN L may only be written back once
+ * IsDurable(L) holds; call WaitDurable(L) before evicting it otherwise.
+ */
+class GroupCommitLog {
+ public:
+  /**
+   * Open (or create) the log file and start the flush thread. LSNs continue after the last intact record
+   * of an existing log; everything from the first torn or corrupt record on is truncated.
+   *
+   * @param path log file path; records are appended after any existing content
+   * @param commit_window how long the flusher waits for more operations to join a batch
+   * @param max_batch number of buffered records that triggers a flush without waiting for the window
+   */
+  explicit GroupCommitLog(const std::string &path,
+                          std::chrono::microseconds commit_window = std::chrono::microseconds(200),
+                          size_t max_batch = 256);
+
+  DISALLOW_COPY_AND_MOVE(GroupCommitLog);
+
+  /** Flushes every buffered record, then stops the flush thread and closes the file. */
+  ~GroupCommitLog();
+
+  /**
+   * @brief Buffer a log record.
+   * @param type the kind of page change
+   * @param page_id the page that changed
+   * @param data redo payload
+   * @param size payload size in bytes
+   * @return the LSN assigned to the record
+   * @throws Exception if an earlier flush of the log failed
+   */
+  auto Append(HashIndexLogType type, page_id_t page_id, const char *data, size_t size) -> lsn_t;
+
+  /**
+   * @brief Block until the record with the given LSN (and every earlier one) is on stable storage.
+   * @throws Exception if no record with that LSN was appended yet, or if the log failed to write or sync it
+   */
+  void WaitDurable(lsn_t lsn);
+
+  /** @brief Whether the record with the given LSN is already on stable storage. */
+  auto IsDurable(lsn_t lsn) const -> bool { return lsn <= persistent_lsn_.load(); }
+
+  /** @brief Get the highest LSN known to be on stable storage, or INVALID_LSN. */
+  auto GetPersistentLSN() const -> lsn_t { return persistent_lsn_.load(); }
+
+  /** @brief Get a snapshot of the commit counters. */
+  auto GetStats() const -> GroupCommitStats;
+
+ private:
+  /** On-disk record header, followed by size_ - sizeof(LogRecordHeader) payload bytes. */
+  struct LogRecordHeader {
+    uint32_t crc_;  // CRC-32 of the rest of the header and the payload
+    uint32_t size_;
+    lsn_t lsn_;
+    HashIndexLogType type_;
+    page_id_t page_id_;
+  };
+
+  /** @brief Scan an existing log for its last intact record, truncating anything after it. */
+  auto ScanLog() -> lsn_t;
+  void FlushLoop();
+
+  int fd_;
+  std::chrono::microseconds commit_window_;
+  size_t max_batch_;
+
+  std::mutex latch_;
+  std::condition_variable flush_cv_;    // wakes the flusher
+  std::condition_variable durable_cv_;  // wakes WaitDurable callers
+  std::string buffer_;
+  size_t buffered_records_{0};
+  lsn_t next_lsn_{0};
+  lsn_t requested_lsn_{INVALID_LSN};  // highest LSN a caller is waiting for
+  bool stop_{false};
+  std::string flush_error_;  // set once a write or fsync fails; the log accepts nothing after that
+  std::atomic<lsn_t> persistent_lsn_{INVALID_LSN};
+
+  std::atomic<uint64_t> records_{0};
+  std::atomic<uint64_t> fsyncs_{0};
+
+  std::thread flush_thread_;
+};
+
+}  // namespace bustub
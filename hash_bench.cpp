@@ -0,0 +1,304 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_bench.cpp
+//
+// Identification: tools/hash_bench/hash_bench.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+// Measurements of the hash table engines against ExtendibleHashTable, and of the log-structured store built on
+// it. Keys come from fixed seeds, so two runs do the same work; timings depend on the machine and should be taken
+// with an optimized build. Latencies are averages over a batch of operations unless a percentile is printed.
+//
+// Usage: hash_bench [frame|cceh|robinhood|lss|bloom|all]
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "container/filter/membership_filter.h"
+#include "container/hash/cceh_hash_table.h"
+#include "container/hash/extendible_hash_table_impl.h"
+#include "container/hash/frame_indexed_table.h"
+#include "container/hash/hash_mix.h"
+#include "container/hash/robin_hood_hash_table.h"
+#include "storage/disk/log_structured_store.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+namespace {
+
+auto ElapsedNanos(std::chrono::steady_clock::time_point start) -> double {
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+/** 2n distinct keys in random order; the first n are inserted, the other n stay absent. */
+auto ShuffledKeys(size_t n, unsigned seed) -> std::vector<int> {
+  std::vector<int> keys(2 * n);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(seed));
+  return keys;
+}
+
+/** Average time of one Find over `lookups` lookups of keys[begin, begin + count), in nanoseconds. */
+template <typename Table, typename Key, typename Value>
+auto FindLatency(Table *table, const std::vector<Key> &keys, size_t begin, size_t count, size_t lookups,
+                 Value *sink) -> double {
+  size_t found = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < lookups; i++) {
+    found += table->Find(keys[begin + i % count], *sink) ? 1 : 0;
+  }
+  double nanos = ElapsedNanos(start) / lookups;
+  if (found != 0 && found != lookups) {
+    std::fprintf(stderr, "lookups found %zu of %zu keys\n", found, lookups);
+    std::exit(1);
+  }
+  return nanos;
+}
+
+/** Insert keys[0, n) with value = key; returns M inserts per second. */
+template <typename Table>
+auto InsertRate(Table *table, const std::vector<int> &keys, size_t n) -> double {
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < n; i++) {
+    table->Insert(keys[i], keys[i]);
+  }
+  return n * 1e3 / ElapsedNanos(start);
+}
+
+// user-101: frame-indexed side array against the Page *-keyed extendible hash table
+void RunFrame() {
+  using Iterator = std::list<Page *>::iterator;
+  const size_t lookups = 2000000;
+  std::printf("per-frame metadata lookup, ns/Find (random frame order)\n");
+  std::printf("%7s %12s %10s %12s\n", "frames", "ext hash", "frame idx", "ext depth");
+  for (size_t frames : {128, 1024, 16384}) {
+    auto pages = std::make_unique<Page[]>(frames);
+    std::list<Page *> lru;
+    ExtendibleHashTable<Page *, Iterator> hashed(4);
+    FrameIndexedTable<Iterator> indexed(pages.get(), frames);
+    std::vector<Page *> order;
+    for (size_t i = 0; i < frames; i++) {
+      auto it = lru.insert(lru.end(), &pages[i]);
+      hashed.Insert(&pages[i], it);
+      indexed.Insert(&pages[i], it);
+      order.push_back(&pages[i]);
+    }
+    std::shuffle(order.begin(), order.end(), std::mt19937(1));
+    Iterator sink;
+    double hashed_ns = FindLatency(&hashed, order, 0, frames, lookups, &sink);
+    double indexed_ns = FindLatency(&indexed, order, 0, frames, lookups, &sink);
+    std::printf("%7zu %12.1f %10.1f %12d\n", frames, hashed_ns, indexed_ns, hashed.GetGlobalDepth());
+  }
+  std::printf("\n");
+}
+
+// user-102: CCEH against the bucket-per-directory-entry extendible hash table
+void RunCCEH() {
+  const size_t lookups = 2000000;
+  std::printf("CCEH (64 buckets/segment, 4-bucket window) vs ExtendibleHashTable (bucket size 8), int -> int\n");
+  std::printf("%8s %-6s %10s %10s %10s %10s\n", "keys", "table", "M ins/s", "hit ns", "miss ns", "dir slots");
+  for (size_t n : {100000, 1000000}) {
+    std::vector<int> keys = ShuffledKeys(n, 2);
+    int sink;
+    ExtendibleHashTable<int, int> ext(8);
+    double ext_rate = InsertRate(&ext, keys, n);
+    double ext_hit = FindLatency(&ext, keys, 0, n, lookups, &sink);
+    double ext_miss = FindLatency(&ext, keys, n, n, lookups, &sink);
+    std::printf("%8zu %-6s %10.2f %10.1f %10.1f %10zu\n", n, "ext", ext_rate, ext_hit, ext_miss,
+                size_t{1} << ext.GetGlobalDepth());
+    CCEHHashTable<int, int> cceh;
+    double cceh_rate = InsertRate(&cceh, keys, n);
+    double cceh_hit = FindLatency(&cceh, keys, 0, n, lookups, &sink);
+    double cceh_miss = FindLatency(&cceh, keys, n, n, lookups, &sink);
+    std::printf("%8zu %-6s %10.2f %10.1f %10.1f %10zu\n", n, "cceh", cceh_rate, cceh_hit, cceh_miss,
+                size_t{1} << cceh.GetGlobalDepth());
+  }
+  std::printf("\n");
+}
+
+// user-105: Robin Hood negative lookups against ExtendibleHashTable::Find
+void RunRobinHood() {
+  const size_t lookups = 2000000;
+  std::printf("negative lookups, ns/Find of an absent key (hits for comparison), int -> int\n");
+  std::printf("%8s %10s %10s %10s %10s %10s\n", "keys", "ext miss", "rh miss", "ext hit", "rh hit", "rh max dist");
+  for (size_t n : {10000, 100000, 1000000}) {
+    std::vector<int> keys = ShuffledKeys(n, 3);
+    int sink;
+    ExtendibleHashTable<int, int> ext(8);
+    RobinHoodHashTable<int, int> robin_hood;
+    InsertRate(&ext, keys, n);
+    InsertRate(&robin_hood, keys, n);
+    double ext_miss = FindLatency(&ext, keys, n, n, lookups, &sink);
+    double rh_miss = FindLatency(&robin_hood, keys, n, n, lookups, &sink);
+    double ext_hit = FindLatency(&ext, keys, 0, n, lookups, &sink);
+    double rh_hit = FindLatency(&robin_hood, keys, 0, n, lookups, &sink);
+    std::printf("%8zu %10.1f %10.1f %10.1f %10.1f %10zu\n", n, ext_miss, rh_miss, ext_hit, rh_hit,
+                robin_hood.GetMaxProbeDistance());
+  }
+  std::printf("\n");
+}
+
+auto StoreKey(size_t i) -> std::string {
+  char key[32];
+  std::snprintf(key, sizeof(key), "key%010zu", i);
+  return key;
+}
+
+// user-107: log-structured store write throughput, read latency and restart time
+void RunLSS() {
+  const size_t n = 200000;
+  const size_t segment_size = 4 << 20;
+  const std::string value(100, 'v');
+  char pattern[] = "/tmp/hash_bench.XXXXXX";
+  if (mkdtemp(pattern) == nullptr) {
+    std::perror("mkdtemp");
+    std::exit(1);
+  }
+  std::string directory = pattern;
+  std::printf("log-structured store, %zu keys of 13 bytes, %zu-byte values, %zu MB segments, in %s\n", n,
+              value.size(), segment_size >> 20, directory.c_str());
+
+  std::vector<size_t> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::shuffle(order.begin(), order.end(), std::mt19937(4));
+  {
+    LogStructuredStore store(directory, segment_size);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i : order) {
+      store.Put(StoreKey(i), value);
+    }
+    store.Sync();
+    double nanos = ElapsedNanos(start);
+    std::printf("write, one Sync at the end:  %8.1f K puts/s %8.1f MB/s\n", n * 1e6 / nanos,
+                n * (value.size() + 13) * 1e3 / nanos);
+
+    // Overwrite a quarter of the keys so compaction has garbage to drop
+    for (size_t i = 0; i < n / 4; i++) {
+      store.Put(StoreKey(order[i]), value);
+    }
+    store.Sync();
+
+    std::vector<double> latencies;
+    std::string read;
+    std::mt19937 rng(5);
+    for (size_t i = 0; i < n; i++) {
+      std::string key = StoreKey(rng() % n);
+      auto get_start = std::chrono::steady_clock::now();
+      bool found = store.Get(key, &read);
+      latencies.push_back(ElapsedNanos(get_start) / 1e3);
+      if (!found) {
+        std::fprintf(stderr, "lost key %s\n", key.c_str());
+        std::exit(1);
+      }
+    }
+    std::sort(latencies.begin(), latencies.end());
+    double mean = std::accumulate(latencies.begin(), latencies.end(), 0.0) / latencies.size();
+    std::printf("read, page cache warm:       mean %.2f us, p50 %.2f us, p99 %.2f us\n", mean,
+                latencies[latencies.size() / 2], latencies[latencies.size() * 99 / 100]);
+  }
+  {
+    auto start = std::chrono::steady_clock::now();
+    LogStructuredStore store(directory, segment_size);
+    std::printf("restart, scanning segments:  %8.1f ms\n", ElapsedNanos(start) / 1e6);
+    start = std::chrono::steady_clock::now();
+    store.Compact();
+    std::printf("compaction:                  %8.1f ms\n", ElapsedNanos(start) / 1e6);
+  }
+  {
+    auto start = std::chrono::steady_clock::now();
+    LogStructuredStore store(directory, segment_size);
+    std::printf("restart, from hint files:    %8.1f ms\n", ElapsedNanos(start) / 1e6);
+  }
+  {
+    const size_t synced = 2000;
+    LogStructuredStore store(directory, segment_size, true);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < synced; i++) {
+      store.Put(StoreKey(i), value);
+    }
+    std::printf("write, sync_on_put:          %8.1f K puts/s\n", synced * 1e6 / ElapsedNanos(start));
+  }
+  std::filesystem::remove_all(directory);
+  std::printf("\n");
+}
+
+// user-109: false-positive rate of the membership filters; fails if the blocked Bloom filter misses its target
+void RunBloom() {
+  const size_t bits_per_key = 10;
+  const size_t probes = 1000000;
+  const double max_rate = 0.02;  // about 1% expected for 10 bits per key and 6 probes in 512-bit blocks
+  std::printf("false-positive rate, %zu bits per key, %zu absent keys probed\n", bits_per_key, probes);
+  std::printf("%7s %-7s %8s %8s\n", "blocks", "hashes", "bloom", "xor");
+  bool failed = false;
+  // Block counts divisible by 512 used to take the block and the probe bits from the same low hash bits
+  for (size_t blocks : {512, 1024, 4096, 65536, 20480, 1000}) {
+    size_t keys = blocks * 512 / bits_per_key;
+    for (bool mixed : {false, true}) {
+      auto hash_of = [mixed](uint64_t key) { return mixed ? HashKey(key) : key; };
+      BlockedBloomFilter bloom(keys, bits_per_key);
+      std::vector<uint64_t> hashes;
+      for (uint64_t key = 0; key < keys; key++) {
+        bloom.Insert(hash_of(key));
+        hashes.push_back(hash_of(key));
+      }
+      XorFilter xor_filter(hashes);
+      size_t bloom_hits = 0;
+      size_t xor_hits = 0;
+      for (uint64_t key = keys; key < keys + probes; key++) {
+        bloom_hits += bloom.MayContain(hash_of(key)) ? 1 : 0;
+        xor_hits += xor_filter.MayContain(hash_of(key)) ? 1 : 0;
+      }
+      double bloom_rate = static_cast<double>(bloom_hits) / probes;
+      std::printf("%7zu %-7s %7.3f%% %7.3f%%%s\n", blocks, mixed ? "mixed" : "ints", 100 * bloom_rate,
+                  100.0 * xor_hits / probes, bloom_rate > max_rate ? "  FAIL" : "");
+      failed = failed || bloom_rate > max_rate;
+    }
+  }
+  std::printf("\n");
+  if (failed) {
+    std::exit(1);
+  }
+}
+
+}  // namespace
+}  // namespace bustub
+
+auto main(int argc, char **argv) -> int {
+  struct Experiment {
+    const char *name_;
+    void (*run_)();
+  };
+  const Experiment experiments[] = {{"frame", bustub::RunFrame},
+                                    {"cceh", bustub::RunCCEH},
+                                    {"robinhood", bustub::RunRobinHood},
+                                    {"lss", bustub::RunLSS},
+                                    {"bloom", bustub::RunBloom}};
+  const char *which = argc > 1 ? argv[1] : "all";
+  bool found = false;
+  for (const auto &experiment : experiments) {
+    if (std::strcmp(which, "all") == 0 || std::strcmp(which, experiment.name_) == 0) {
+      experiment.run_();
+      found = true;
+    }
+  }
+  if (!found) {
+    std::fprintf(stderr, "usage: %s [frame|cceh|robinhood|lss|bloom|all]\n", argv[0]);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,37 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_mix.h
+//
+// Identification: src/include/container/hash/hash_mix.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace bustub {
+
+/**
+ * @brief Hash a key for the hash table engines that use both the low and the high bits of the hash.
+ *
+ * std::hash is the identity for integers, so its result is passed through the murmur3 64-bit finalizer,
+ * which makes every output bit depend on every input bit.
+ */
+template <typename K>
+inline auto HashKey(const K &key) -> uint64_t {
+  auto h = static_cast<uint64_t>(std::hash<K>()(key));
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+}  // namespace bustub
@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <functional>
+#include <list>
+#include <string>
+#include <utility>
+
+#include "container/hash/hopscotch_hash_table.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+template <typename K, typename V>
+HopscotchHashTable<K, V>::HopscotchHashTable(size_t initial_capacity) {
+  size_t capacity = NEIGHBORHOOD_SIZE;
+  while (capacity < initial_capacity) {
+    capacity <<= 1;
+  }
+  Reset(capacity);
+}
+
+template <typename K, typename V>
+void HopscotchHashTable<K, V>::Reset(size_t capacity) {
+  keys_.assign(capacity, K{});
+  values_.assign(capacity, V{});
+  hop_info_.assign(capacity, 0);
+  occupied_.assign(capacity, 0);
+}
+
+template <typename K, typename V>
+void HopscotchHashTable<K, V>::MoveSlot(size_t from, size_t to) {
+  keys_[to] = std::move(keys_[from]);
+  values_[to] = std::move(values_[from]);
+  occupied_[to] = 1;
+  occupied_[from] = 0;
+}
+
+template <typename K, typename V>
+auto HopscotchHashTable<K, V>::GetCapacity() const -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return keys_.size();
+}
+
+template <typename K, typename V>
+auto HopscotchHashTable<K, V>::GetLoadFactor() const -> double {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return static_cast<double>(size_) / static_cast<double>(keys_.size());
+}
+
+template <typename K, typename V>
+auto HopscotchHashTable<K, V>::GetBytesPerEntry() const -> double {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (size_ == 0) {
+    return 0;
+  }
+  size_t slot_bytes = sizeof(K) + sizeof(V) + sizeof(HopBitmap) + sizeof(uint8_t);
+  return static_cast<double>(keys_.size() * slot_bytes) / static_cast<double>(size_);
+}
+
+template <typename K, typename V>
+auto HopscotchHashTable<K, V>::Locate(const K &key) const -> int64_t {
+  size_t home = HashKey(key) & Mask();
+  HopBitmap hop_info = hop_info_[home];
+  while (hop_info != 0) {
+    size_t offset = __builtin_ctz(hop_info);
+    size_t index = (home + offset) & Mask();
+    if (keys_[index] == key) {
+      return static_cast<int64_t>(index);
+    }
+    hop_info &= hop_info - 1;
+  }
+  return -1;
+}
+
+template <typename K, typename V>
+auto HopscotchHashTable<K, V>::Find(const K &key, V &value) -> bool {
+  std::scoped_lock<std::mutex> locker(latch_);
+  int64_t index = Locate(key);
+  if (index < 0) {
+    return false;
+  }
+  value = values_[index];
+  return true;
+}
+
+template <typename K, typename V>
+auto HopscotchHashTable<K, V>::Remove(const K &key) -> bool {
+  std::scoped_lock<std::mutex> locker(latch_);
+  int64_t index = Locate(key);
+  if (index < 0) {
+    return false;
+  }
+  size_t home = HashKey(key) & Mask();
+  occupied_[index] = 0;
+  hop_info_[home] &= ~(HopBitmap{1} << ((static_cast<size_t>(index) - home) & Mask()));
+  size_--;
+  return true;
+}
+
+template <typename K, typename V>
+void HopscotchHashTable<K, V>::Insert(const K &key, const V &value) {
+  std::scoped_lock<std::mutex> locker(latch_);
+  int64_t index = Locate(key);
+  if (index >= 0) {
+    values_[index] = value;
+    return;
+  }
+  while (!InsertNew(key, value)) {
+    Grow();
+  }
+}
+
+template <typename K, typename V>
+auto HopscotchHashTable<K, V>::InsertNew(const K &key, const V &value) -> bool {
+  size_t capacity = keys_.size();
+  size_t home = HashKey(key) & Mask();
+
+  // 1. 线性探测找到最近的空槽
+  size_t distance = 0;
+  size_t probe_limit = std::min(capacity, MAX_PROBE);
+  while (distance < probe_limit && occupied_[(home + distance) & Mask()] != 0) {
+    distance++;
+  }
+  if (distance == probe_limit) {
+    return false;
+  }
+
+  // 2. 空槽离主桶太远时，把空槽往回“跳”：找一个可以合法前移到空槽的元素与之交换
+  while (distance >= NEIGHBORHOOD_SIZE) {
+    size_t free_index = (home + distance) & Mask();
+    bool moved = false;
+    for (size_t back = NEIGHBORHOOD_SIZE - 1; back > 0 && !moved; back--) {
+      size_t candidate_home = (free_index - back) & Mask();
+      HopBitmap hop_info = hop_info_[candidate_home];
+      // The earliest entry of candidate_home that sits before the free slot can move there
+      for (size_t offset = 0; offset < back; offset++) {
+        if ((hop_info & (HopBitmap{1} << offset)) == 0) {
+          continue;
+        }
+        MoveSlot((candidate_home + offset) & Mask(), free_index);
+        hop_info_[candidate_home] = (hop_info & ~(HopBitmap{1} << offset)) | (HopBitmap{1} << back);
+        distance -= back - offset;
+        moved = true;
+        break;
+      }
+    }
+    if (!moved) {
+      return false;
+    }
+  }
+
+  size_t index = (home + distance) & Mask();
+  keys_[index] = key;
+  values_[index] = value;
+  occupied_[index] = 1;
+  hop_info_[home] |= HopBitmap{1} << distance;
+  size_++;
+  return true;
+}
+
+template <typename K, typename V>
+void HopscotchHashTable<K, V>::Grow() {
+  std::vector<K> old_keys = std::move(keys_);
+  std::vector<V> old_values = std::move(values_);
+  std::vector<uint8_t> old_occupied = std::move(occupied_);
+  Reset(old_keys.size() * 2);
+  size_ = 0;
+  for (size_t i = 0; i < old_keys.size(); i++) {
+    if (old_occupied[i] != 0) {
+      // A larger table always has room for the same keys; grow again in the rare pathological case
+      while (!InsertNew(old_keys[i], old_values[i])) {
+        Grow();
+      }
+    }
+  }
+}
+
+template class HopscotchHashTable<page_id_t, Page *>;
+template class HopscotchHashTable<int, int>;
+template class HopscotchHashTable<int, std::string>;
+template class HopscotchHashTable<int, std::list<int>::iterator>;
+
+}  // namespace bustub
@@ -0,0 +1,136 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hopscotch_hash_table.h
+//
+// Identification: src/include/container/hash/hopscotch_hash_table.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+/**
+ * hopscotch_hash_table.h
+ *
+ * Implementation of in-memory hash table using hopscotch hashing
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "container/hash/hash_mix.h"
+#include "container/hash/hash_table.h"
+
+namespace bustub {
+
+/**
+ * HopscotchHashTable is an open-addressing hash table that runs at high load factors with bounded probes.
+ *
+ * Every key lives within NEIGHBORHOOD_SIZE slots of its home bucket, and the home bucket keeps a hop
+ * bitmap of which of those slots hold its keys. An insert whose nearest free slot is too far away "hops"
+ * the free slot backwards by moving entries that can legally move forward, and the table only doubles
+ * when no such sequence exists; with 32 slots that happens at a load factor of about 0.9.
+ *
+ * Keys, values and hop bitmaps live in separate arrays, so a lookup reads one bitmap and then compares at
+ * most NEIGHBORHOOD_SIZE consecutive keys, e.g. two cache lines for int keys; the value is only read on
+ * a hit.
+ *
+ * @tparam K key type
+ * @tparam V value type
+ */
+template <typename K, typename V>
+class HopscotchHashTable : public HashTable<K, V> {
+ public:
+  /** Neighbourhood size; the keys of a neighbourhood span 128 bytes for int keys. */
+  static constexpr size_t NEIGHBORHOOD_SIZE = 32;
+
+  /**
+   * @brief Create a new HopscotchHashTable.
+   * @param initial_capacity number of slots to start with, rounded up to a power of two
+   */
+  explicit HopscotchHashTable(size_t initial_capacity = 64);
+
+  /**
+   * @brief Get the number of slots in the table.
+   * @return The number of slots.
+   */
+  auto GetCapacity() const -> size_t;
+
+  /**
+   * @brief Get the fraction of slots that hold an entry.
+   * @return The load factor of the table.
+   */
+  auto GetLoadFactor() const -> double;
+
+  /**
+   * @brief Get the bytes of slot storage used per stored entry.
+   * @return Bytes per entry, or 0 if the table is empty.
+   */
+  auto GetBytesPerEntry() const -> double;
+
+  /**
+   * @brief Find the value associated with the given key.
+   * @param key The key to be searched.
+   * @param[out] value The value associated with the key.
+   * @return True if the key is found, false otherwise.
+   */
+  auto Find(const K &key, V &value) -> bool override;
+
+  /**
+   * @brief Insert the given key-value pair into the hash table.
+   * If a key already exists, the value should be updated.
+   * If no free slot can be brought into the key's neighbourhood, double the table and retry.
+   * @param key The key to be inserted.
+   * @param value The value to be inserted.
+   */
+  void Insert(const K &key, const V &value) override;
+
+  /**
+   * @brief Given the key, remove the corresponding key-value pair in the hash table.
+   * @param key The key to be deleted.
+   * @return True if the key exists, false otherwise.
+   */
+  auto Remove(const K &key) -> bool override;
+
+ private:
+  /** How far past the home bucket Insert looks for a free slot before giving up and resizing. */
+  static constexpr size_t MAX_PROBE = 1024;
+
+  using HopBitmap = uint32_t;
+  static_assert(NEIGHBORHOOD_SIZE <= sizeof(HopBitmap) * 8, "the hop bitmap needs a bit per neighbourhood slot");
+
+  size_t size_{0};
+  mutable std::mutex latch_;
+  // Slot i of the table is keys_[i], values_[i] and occupied_[i]; hop_info_[i] belongs to bucket i as a home
+  std::vector<K> keys_;
+  std::vector<V> values_;
+  std::vector<HopBitmap> hop_info_;  // bit j set => slot (i + j) holds a key whose home is bucket i
+  std::vector<uint8_t> occupied_;    // 1 if the slot holds an entry
+
+  /*****************************************************************
+   * Must acquire latch_ first before calling the below functions. *
+   *****************************************************************/
+
+  auto Mask() const -> size_t { return keys_.size() - 1; }
+
+  /** @brief Allocate `capacity` empty slots, dropping the current contents. */
+  void Reset(size_t capacity);
+
+  /** @brief Move the entry in slot `from` to the free slot `to`. */
+  void MoveSlot(size_t from, size_t to);
+
+  /** @brief Return the slot holding the key, or -1. */
+  auto Locate(const K &key) const -> int64_t;
+
+  /** @brief Place a key known to be absent; returns false if the table has to grow first. */
+  auto InsertNew(const K &key, const V &value) -> bool;
+
+  /** @brief Double the table and reinsert every entry. */
+  void Grow();
+};
+
+}  // namespace bustub
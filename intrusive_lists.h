@@ -0,0 +1,83 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// intrusive_lists.h
+//
+// Identification: src/include/buffer/intrusive_lists.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+namespace bustub {
+
+/**
+ * IntrusiveLists keeps circular doubly linked lists over a fixed set of nodes numbered 0..num_nodes-1, linked
+ * by index instead of by pointer. Replacers use frame i as node i and put one sentinel node per list after the
+ * frames; a list is empty when its sentinel points to itself, and a node that is in no list is a self-loop.
+ * Every operation is O(1) and allocates nothing.
+ *
+ * Not thread-safe; the owner's latch protects it.
+ */
+class IntrusiveLists {
+ public:
+  /** @param num_nodes number of nodes, sentinels included; every node starts unlinked */
+  explicit IntrusiveLists(size_t num_nodes = 0) : links_(num_nodes) {
+    for (size_t i = 0; i < num_nodes; i++) {
+      links_[i] = {i, i};
+    }
+  }
+
+  auto IsEmpty(size_t sentinel) const -> bool { return links_[sentinel].next_ == sentinel; }
+
+  /** @brief The first node of a list, or the sentinel itself if the list is empty. */
+  auto Front(size_t sentinel) const -> size_t { return links_[sentinel].next_; }
+
+  /** @brief The node after `node` in its list; the sentinel after the last node. */
+  auto Next(size_t node) const -> size_t { return links_[node].next_; }
+
+  /** @brief Remove a node from its list; it becomes a self-loop. */
+  void Unlink(size_t node) {
+    links_[links_[node].prev_].next_ = links_[node].next_;
+    links_[links_[node].next_].prev_ = links_[node].prev_;
+    links_[node] = {node, node};
+  }
+
+  /** @brief Insert an unlinked node right before `pos`; before a sentinel means at the back of its list. */
+  void LinkBefore(size_t node, size_t pos) {
+    size_t prev = links_[pos].prev_;
+    links_[node] = {prev, pos};
+    links_[prev].next_ = node;
+    links_[pos].prev_ = node;
+  }
+
+  /** @brief Move every node of one list to the front of another. */
+  void SpliceFront(size_t from, size_t to) {
+    if (from == to || IsEmpty(from)) {
+      return;
+    }
+    size_t first = links_[from].next_;
+    size_t last = links_[from].prev_;
+    size_t old_first = links_[to].next_;
+    links_[to].next_ = first;
+    links_[first].prev_ = to;
+    links_[last].next_ = old_first;
+    links_[old_first].prev_ = last;
+    links_[from] = {from, from};
+  }
+
+ private:
+  struct Link {
+    size_t prev_;
+    size_t next_;
+  };
+
+  std::vector<Link> links_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,439 @@
+#include "storage/disk/log_structured_store.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <set>
+#include <tuple>
+#include <utility>
+
+#include "common/crc32.h"
+#include "common/exception.h"
+// The keydir's value type belongs to this layer, so its instantiation of the hash table lives here
+#include "container/hash/extendible_hash_table_impl.h"
+
+namespace bustub {
+
+namespace {
+constexpr uint32_t HINT_MAGIC = 0x544e4948;  // "HINT"
+
+struct HintHeader {
+  uint32_t magic_;
+  uint32_t merged_from_;
+};
+
+struct HintEntry {
+  uint32_t key_len_;
+  uint32_t value_len_;
+  uint64_t value_offset_;
+};
+
+/** pread until `size` bytes are read or EOF; returns the number of bytes read. */
+auto ReadFully(int fd, char *buf, size_t size, uint64_t offset) -> size_t {
+  size_t done = 0;
+  while (done < size) {
+    ssize_t n = pread(fd, buf + done, size - done, static_cast<off_t>(offset + done));
+    if (n < 0) {
+      throw Exception("failed to read segment file: " + std::string(strerror(errno)));
+    }
+    if (n == 0) {
+      break;
+    }
+    done += static_cast<size_t>(n);
+  }
+  return done;
+}
+
+void WriteFully(int fd, const char *buf, size_t size, uint64_t offset) {
+  size_t done = 0;
+  while (done < size) {
+    ssize_t n = pwrite(fd, buf + done, size - done, static_cast<off_t>(offset + done));
+    if (n < 0) {
+      throw Exception("failed to write segment file: " + std::string(strerror(errno)));
+    }
+    done += static_cast<size_t>(n);
+  }
+}
+
+/** fsync a file or directory; a failed fsync may have dropped the dirty pages, so the caller must fail too. */
+void SyncFile(int fd, const std::string &what) {
+  if (fsync(fd) != 0) {
+    throw Exception("failed to sync " + what + ": " + std::string(strerror(errno)));
+  }
+}
+
+auto FileSize(int fd) -> uint64_t {
+  struct stat st {};
+  if (fstat(fd, &st) != 0) {
+    throw Exception("failed to stat segment file: " + std::string(strerror(errno)));
+  }
+  return static_cast<uint64_t>(st.st_size);
+}
+}  // namespace
+
+LogStructuredStore::LogStructuredStore(std::string directory, size_t max_segment_size, bool sync_on_put)
+    : directory_(std::move(directory)), max_segment_size_(max_segment_size), sync_on_put_(sync_on_put), keydir_(64) {
+  std::filesystem::create_directories(directory_);
+  Recover();
+}
+
+LogStructuredStore::~LogStructuredStore() {
+  {
+    std::scoped_lock<std::mutex> lock(stop_latch_);
+    stop_ = true;
+  }
+  stop_cv_.notify_all();
+  if (compaction_thread_.joinable()) {
+    compaction_thread_.join();
+  }
+  for (auto &[id, fd] : segment_fds_) {
+    close(fd);
+  }
+}
+
+auto LogStructuredStore::SegmentPath(uint32_t id) const -> std::string {
+  return directory_ + "/" + std::to_string(id) + ".log";
+}
+
+auto LogStructuredStore::HintPath(uint32_t id) const -> std::string {
+  return directory_ + "/" + std::to_string(id) + ".hint";
+}
+
+auto LogStructuredStore::OpenFile(const std::string &path, bool create) -> int {
+  int fd = open(path.c_str(), create ? O_RDWR | O_CREAT | O_TRUNC : O_RDWR, 0644);
+  if (fd < 0) {
+    throw Exception("can't open segment file " + path + ": " + std::string(strerror(errno)));
+  }
+  return fd;
+}
+
+auto LogStructuredStore::AppendRecord(int fd, uint32_t segment_id, uint64_t offset, uint32_t flags,
+                                      const std::string &key, const std::string &value) -> RecordLocation {
+  RecordHeader header{0, flags, static_cast<uint32_t>(key.size()), static_cast<uint32_t>(value.size())};
+  std::string buf(sizeof(RecordHeader) + key.size() + value.size(), '\0');
+  memcpy(buf.data(), &header, sizeof(RecordHeader));
+  memcpy(buf.data() + sizeof(RecordHeader), key.data(), key.size());
+  memcpy(buf.data() + sizeof(RecordHeader) + key.size(), value.data(), value.size());
+  // The checksum covers everything after the crc field itself
+  header.crc_ = Crc32(buf.data() + sizeof(uint32_t), buf.size() - sizeof(uint32_t));
+  memcpy(buf.data(), &header.crc_, sizeof(uint32_t));
+  WriteFully(fd, buf.data(), buf.size(), offset);
+  return {segment_id, header.value_len_, offset + sizeof(RecordHeader) + key.size()};
+}
+
+auto LogStructuredStore::ScanSegment(uint32_t id, int fd) -> std::vector<ScannedRecord> {
+  std::string data(FileSize(fd), '\0');
+  data.resize(ReadFully(fd, data.data(), data.size(), 0));
+
+  std::vector<ScannedRecord> records;
+  uint64_t offset = 0;
+  while (offset + sizeof(RecordHeader) <= data.size()) {
+    RecordHeader header;
+    memcpy(&header, data.data() + offset, sizeof(RecordHeader));
+    uint64_t record_size = sizeof(RecordHeader) + header.key_len_ + header.value_len_;
+    if (offset + record_size > data.size() ||
+        Crc32(data.data() + offset + sizeof(uint32_t), record_size - sizeof(uint32_t)) != header.crc_) {
+      // 尾部记录写了一半（崩溃）或已损坏，之后的内容都不可信
+      break;
+    }
+    ScannedRecord record;
+    record.flags_ = header.flags_;
+    record.key_.assign(data.data() + offset + sizeof(RecordHeader), header.key_len_);
+    record.location_ = {id, header.value_len_, offset + sizeof(RecordHeader) + header.key_len_};
+    records.push_back(std::move(record));
+    offset += record_size;
+  }
+  return records;
+}
+
+auto LogStructuredStore::MergeLowerBound(uint32_t id, int fd) -> uint32_t {
+  int hint_fd = open(HintPath(id).c_str(), O_RDONLY);
+  if (hint_fd >= 0) {
+    HintHeader header{};
+    size_t n = ReadFully(hint_fd, reinterpret_cast<char *>(&header), sizeof(header), 0);
+    close(hint_fd);
+    if (n == sizeof(header) && header.magic_ == HINT_MAGIC) {
+      return header.merged_from_;
+    }
+  }
+  // No usable hint: a merge output starts with a marker record carrying the lowest merged id
+  RecordHeader header{};
+  uint32_t merged_from = id;
+  if (ReadFully(fd, reinterpret_cast<char *>(&header), sizeof(header), 0) == sizeof(header) &&
+      header.flags_ == MERGE_MARKER && header.key_len_ == 0 && header.value_len_ == sizeof(uint32_t)) {
+    ReadFully(fd, reinterpret_cast<char *>(&merged_from), sizeof(merged_from), sizeof(header));
+  }
+  return merged_from;
+}
+
+auto LogStructuredStore::LoadHint(uint32_t id) -> bool {
+  int fd = open(HintPath(id).c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  std::string data(FileSize(fd), '\0');
+  data.resize(ReadFully(fd, data.data(), data.size(), 0));
+  close(fd);
+
+  HintHeader header{};
+  if (data.size() < sizeof(header)) {
+    return false;
+  }
+  memcpy(&header, data.data(), sizeof(header));
+  if (header.magic_ != HINT_MAGIC) {
+    return false;
+  }
+  size_t offset = sizeof(header);
+  while (offset + sizeof(HintEntry) <= data.size()) {
+    HintEntry entry{};
+    memcpy(&entry, data.data() + offset, sizeof(entry));
+    offset += sizeof(entry);
+    if (offset + entry.key_len_ > data.size()) {
+      break;
+    }
+    keydir_.Insert(data.substr(offset, entry.key_len_), {id, entry.value_len_, entry.value_offset_});
+    offset += entry.key_len_;
+  }
+  return true;
+}
+
+void LogStructuredStore::Recover() {
+  std::vector<uint32_t> ids;
+  for (const auto &entry : std::filesystem::directory_iterator(directory_)) {
+    const auto &path = entry.path();
+    if (path.extension() == ".merge") {
+      // Leftover of a compaction that crashed before switching over
+      std::filesystem::remove(path);
+    } else if (path.extension() == ".log") {
+      ids.push_back(static_cast<uint32_t>(std::stoul(path.stem().string())));
+    }
+  }
+  std::sort(ids.begin(), ids.end());
+  for (uint32_t id : ids) {
+    segment_fds_[id] = OpenFile(SegmentPath(id), false);
+  }
+
+  // A merge output supersedes every lower segment it was built from; inputs may survive a crash
+  std::set<uint32_t> superseded;
+  for (auto it = ids.rbegin(); it != ids.rend(); ++it) {
+    if (superseded.count(*it) != 0) {
+      continue;
+    }
+    uint32_t merged_from = MergeLowerBound(*it, segment_fds_[*it]);
+    for (uint32_t id : ids) {
+      if (id >= merged_from && id < *it) {
+        superseded.insert(id);
+      }
+    }
+  }
+  for (uint32_t id : superseded) {
+    close(segment_fds_[id]);
+    segment_fds_.erase(id);
+    std::filesystem::remove(SegmentPath(id));
+    std::filesystem::remove(HintPath(id));
+  }
+
+  for (auto &[id, fd] : segment_fds_) {
+    if (LoadHint(id)) {
+      continue;
+    }
+    for (auto &record : ScanSegment(id, fd)) {
+      if (record.flags_ == PUT) {
+        keydir_.Insert(record.key_, record.location_);
+      } else if (record.flags_ == TOMBSTONE) {
+        keydir_.Remove(record.key_);
+      }
+    }
+  }
+
+  active_id_ = segment_fds_.empty() ? 1 : segment_fds_.rbegin()->first + 1;
+  segment_fds_[active_id_] = OpenFile(SegmentPath(active_id_), true);
+  active_offset_ = 0;
+}
+
+void LogStructuredStore::RotateActiveSegment() {
+  SyncFile(segment_fds_.at(active_id_), SegmentPath(active_id_));
+  active_id_++;
+  segment_fds_[active_id_] = OpenFile(SegmentPath(active_id_), true);
+  active_offset_ = 0;
+}
+
+void LogStructuredStore::Put(const std::string &key, const std::string &value) {
+  std::unique_lock lock(latch_);
+  if (active_offset_ >= max_segment_size_) {
+    RotateActiveSegment();
+  }
+  int fd = segment_fds_.at(active_id_);
+  RecordLocation location = AppendRecord(fd, active_id_, active_offset_, PUT, key, value);
+  active_offset_ = location.offset_ + location.length_;
+  if (sync_on_put_) {
+    SyncFile(fd, SegmentPath(active_id_));
+  }
+  keydir_.Insert(key, location);
+}
+
+auto LogStructuredStore::Get(const std::string &key, std::string *value) -> bool {
+  std::shared_lock lock(latch_);
+  RecordLocation location;
+  if (!keydir_.Find(key, location)) {
+    return false;
+  }
+  value->resize(location.length_);
+  if (ReadFully(segment_fds_.at(location.segment_id_), value->data(), location.length_, location.offset_) !=
+      location.length_) {
+    throw Exception("segment file is shorter than the keydir expects");
+  }
+  return true;
+}
+
+auto LogStructuredStore::Delete(const std::string &key) -> bool {
+  std::unique_lock lock(latch_);
+  RecordLocation location;
+  if (!keydir_.Find(key, location)) {
+    return false;
+  }
+  if (active_offset_ >= max_segment_size_) {
+    RotateActiveSegment();
+  }
+  int fd = segment_fds_.at(active_id_);
+  RecordLocation tombstone = AppendRecord(fd, active_id_, active_offset_, TOMBSTONE, key, "");
+  active_offset_ = tombstone.offset_;
+  if (sync_on_put_) {
+    SyncFile(fd, SegmentPath(active_id_));
+  }
+  keydir_.Remove(key);
+  return true;
+}
+
+void LogStructuredStore::Sync() {
+  std::shared_lock lock(latch_);
+  SyncFile(segment_fds_.at(active_id_), SegmentPath(active_id_));
+}
+
+void LogStructuredStore::Compact() {
+  std::scoped_lock<std::mutex> compaction_lock(compaction_latch_);
+
+  // Immutable segments never change until a compaction replaces them, so they can be read unlatched
+  std::vector<std::pair<uint32_t, int>> inputs;
+  {
+    std::shared_lock lock(latch_);
+    for (auto &[id, fd] : segment_fds_) {
+      if (id != active_id_) {
+        inputs.emplace_back(id, fd);
+      }
+    }
+  }
+  // A lone segment that is already a merge output has nothing to gain from being merged again
+  if (inputs.empty() || (inputs.size() == 1 && std::filesystem::exists(HintPath(inputs[0].first)))) {
+    return;
+  }
+  uint32_t target = inputs.back().first;
+  uint32_t merged_from = inputs.front().first;
+  std::string merge_path = SegmentPath(target) + ".merge";
+  std::string hint_merge_path = HintPath(target) + ".merge";
+
+  // 1. Copy every record the keydir still points to into the merge output, collecting hint entries
+  int merge_fd = OpenFile(merge_path, true);
+  std::string marker(reinterpret_cast<const char *>(&merged_from), sizeof(merged_from));
+  uint64_t offset = AppendRecord(merge_fd, target, 0, MERGE_MARKER, "", marker).offset_ + sizeof(merged_from);
+
+  HintHeader hint_header{HINT_MAGIC, merged_from};
+  std::string hint(reinterpret_cast<const char *>(&hint_header), sizeof(hint_header));
+  std::vector<std::tuple<std::string, RecordLocation, RecordLocation>> moved;
+  std::string value;
+  for (auto &[id, fd] : inputs) {
+    for (auto &record : ScanSegment(id, fd)) {
+      RecordLocation current;
+      if (record.flags_ != PUT || !keydir_.Find(record.key_, current) || !(current == record.location_)) {
+        continue;
+      }
+      value.resize(record.location_.length_);
+      ReadFully(fd, value.data(), value.size(), record.location_.offset_);
+      RecordLocation location = AppendRecord(merge_fd, target, offset, PUT, record.key_, value);
+      offset = location.offset_ + location.length_;
+
+      HintEntry entry{static_cast<uint32_t>(record.key_.size()), location.length_, location.offset_};
+      hint.append(reinterpret_cast<const char *>(&entry), sizeof(entry));
+      hint.append(record.key_);
+      moved.emplace_back(std::move(record.key_), record.location_, location);
+    }
+  }
+  int hint_fd = -1;
+  try {
+    SyncFile(merge_fd, merge_path);
+    hint_fd = OpenFile(hint_merge_path, true);
+    WriteFully(hint_fd, hint.data(), hint.size(), 0);
+    SyncFile(hint_fd, hint_merge_path);
+    close(hint_fd);
+  } catch (...) {
+    // Nothing has been switched over yet; the inputs stay authoritative
+    if (hint_fd >= 0) {
+      close(hint_fd);
+    }
+    close(merge_fd);
+    std::filesystem::remove(merge_path);
+    std::filesystem::remove(hint_merge_path);
+    throw;
+  }
+
+  // 2. Switch over: replace the files, then repoint keys that did not change meanwhile. The log is
+  // renamed before the hint so a crash never pairs a new hint with an old log.
+  std::unique_lock lock(latch_);
+  std::filesystem::remove(HintPath(target));
+  std::filesystem::rename(merge_path, SegmentPath(target));
+  std::filesystem::rename(hint_merge_path, HintPath(target));
+  for (auto &[key, from, to] : moved) {
+    RecordLocation current;
+    if (keydir_.Find(key, current) && current == from) {
+      keydir_.Insert(key, to);
+    }
+  }
+  for (auto &[id, fd] : inputs) {
+    close(fd);
+    segment_fds_.erase(id);
+  }
+  segment_fds_[target] = merge_fd;
+
+  // 3. Drop the inputs only once the renames are durable. If the directory can't be synced, the inputs stay
+  // on disk and Recover() removes them as superseded by the merge output (or keeps them if the rename was lost).
+  int dir_fd = open(directory_.c_str(), O_RDONLY);
+  if (dir_fd < 0 || fsync(dir_fd) != 0) {
+    std::string error = strerror(errno);
+    if (dir_fd >= 0) {
+      close(dir_fd);
+    }
+    throw Exception("failed to sync directory " + directory_ + ": " + error);
+  }
+  close(dir_fd);
+  for (auto &[id, fd] : inputs) {
+    if (id != target) {
+      std::filesystem::remove(SegmentPath(id));
+      std::filesystem::remove(HintPath(id));
+    }
+  }
+}
+
+void LogStructuredStore::StartBackgroundCompaction(std::chrono::milliseconds interval) {
+  BUSTUB_ASSERT(!compaction_thread_.joinable(), "background compaction already started");
+  compaction_thread_ = std::thread([this, interval] {
+    std::unique_lock<std::mutex> lock(stop_latch_);
+    while (!stop_cv_.wait_for(lock, interval, [this] { return stop_; })) {
+      lock.unlock();
+      try {
+        Compact();
+      } catch (const std::exception &) {
+        // A failed compaction leaves its inputs in place; the next interval tries again
+      }
+      lock.lock();
+    }
+  });
+}
+
+template class ExtendibleHashTable<std::string, RecordLocation>;
+
+}  // namespace bustub
@@ -0,0 +1,173 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// log_structured_store.h
+//
+// Identification: src/include/storage/disk/log_structured_store.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <map>
+#include <mutex>  // NOLINT
+#include <shared_mutex>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/macros.h"
+#include "container/hash/extendible_hash_table.h"
+
+namespace bustub {
+
+/**
+ * Where the latest value of a key lives on disk.
+ */
+struct RecordLocation {
+  uint32_t segment_id_{0};
+  uint32_t length_{0};  // length of the value in bytes
+  uint64_t offset_{0};  // file offset of the value bytes
+
+  auto operator==(const RecordLocation &other) const -> bool {
+    return segment_id_ == other.segment_id_ && offset_ == other.offset_ && length_ == other.length_;
+  }
+};
+
+/**
+ * LogStructuredStore is a durable key-value store in the style of Bitcask.
+ *
+ * Every Put/Delete appends a checksummed record to the active segment file; once the active segment
+ * reaches max_segment_size it becomes immutable and a new one is opened. An ExtendibleHashTable (the
+ * keydir) maps every live key to the segment, offset and length of its latest value, so a Get is one
+ * hash lookup plus one pread.
+ *
+ * Compact() merges all immutable segments into one, keeping only records the keydir still points to,
+ * and writes a hint file next to it. On startup, segments with a hint file are loaded from the hint
+ * (key and location only) instead of being scanned record by record.
+ */
+class LogStructuredStore {
+ public:
+  /**
+   * Open (or create) a store in the given directory and rebuild the keydir from its segments.
+   *
+   * @param directory directory that holds the segment and hint files
+   * @param max_segment_size size in bytes after which the active segment is rotated
+   * @param sync_on_put fsync the active segment after every Put/Delete
+   */
+  explicit LogStructuredStore(std::string directory, size_t max_segment_size = 64 << 20, bool sync_on_put = false);
+
+  DISALLOW_COPY_AND_MOVE(LogStructuredStore);
+
+  /**
+   * Stops background compaction and closes all segment files. Closing does not sync: call Sync() first to make
+   * unsynced writes durable and to learn whether that failed.
+   */
+  ~LogStructuredStore();
+
+  /**
+   * @brief Store the value of a key, replacing any previous value.
+   * @throws Exception if the record can't be written, or synced with sync_on_put; the key keeps its old value
+   */
+  void Put(const std::string &key, const std::string &value);
+
+  /**
+   * @brief Read the latest value of a key.
+   * @param[out] value the value of the key
+   * @return true if the key exists
+   */
+  auto Get(const std::string &key, std::string *value) -> bool;
+
+  /**
+   * @brief Delete a key by appending a tombstone.
+   * @return true if the key existed
+   * @throws Exception if the tombstone can't be written, or synced with sync_on_put; the key is then kept
+   */
+  auto Delete(const std::string &key) -> bool;
+
+  /**
+   * @brief fsync the active segment.
+   * @throws Exception if the sync fails; writes since the last successful sync may then be lost
+   */
+  void Sync();
+
+  /**
+   * @brief Merge all immutable segments into one segment plus hint file and drop the inputs.
+   * Reads and writes may proceed concurrently; only the final switch-over takes the store latch.
+   * @throws Exception if the output or the directory can't be synced; the inputs are then kept on disk
+   */
+  void Compact();
+
+  /**
+   * @brief Run Compact() periodically on a background thread until the store is destroyed. A compaction that
+   * fails keeps its inputs and is retried on the next interval.
+   * @param interval time between compactions
+   */
+  void StartBackgroundCompaction(std::chrono::milliseconds interval);
+
+ private:
+  enum RecordFlag : uint32_t { PUT = 0, TOMBSTONE = 1, MERGE_MARKER = 2 };
+
+  /** On-disk record header; followed by key_len_ key bytes and value_len_ value bytes. */
+  struct RecordHeader {
+    uint32_t crc_;
+    uint32_t flags_;
+    uint32_t key_len_;
+    uint32_t value_len_;
+  };
+
+  /** A live record found while scanning or merging a segment. */
+  struct ScannedRecord {
+    uint32_t flags_;
+    std::string key_;
+    RecordLocation location_;
+  };
+
+  auto SegmentPath(uint32_t id) const -> std::string;
+  auto HintPath(uint32_t id) const -> std::string;
+
+  /** @brief Open a file for reading and appending, throwing on failure. */
+  auto OpenFile(const std::string &path, bool create) -> int;
+  /** @brief Append a record to an open file at offset; returns the location of its value. */
+  auto AppendRecord(int fd, uint32_t segment_id, uint64_t offset, uint32_t flags, const std::string &key,
+                    const std::string &value) -> RecordLocation;
+  /** @brief Read every valid record of a segment, stopping at the first torn or corrupt one. */
+  auto ScanSegment(uint32_t id, int fd) -> std::vector<ScannedRecord>;
+  /** @brief The lowest segment id merged into this segment, or the id itself if it is not a merge output. */
+  auto MergeLowerBound(uint32_t id, int fd) -> uint32_t;
+  auto LoadHint(uint32_t id) -> bool;
+
+  /** Must hold latch_ exclusively. */
+  void RotateActiveSegment();
+  /** Rebuild the keydir from the segment files. */
+  void Recover();
+
+  std::string directory_;
+  size_t max_segment_size_;
+  bool sync_on_put_;
+
+  /** Keydir: key -> location of its latest value. */
+  ExtendibleHashTable<std::string, RecordLocation> keydir_;
+
+  /** Protects the segment files and the active segment; Get holds it shared. */
+  std::shared_mutex latch_;
+  std::map<uint32_t, int> segment_fds_;
+  uint32_t active_id_{0};
+  uint64_t active_offset_{0};
+
+  /** Serializes compactions. */
+  std::mutex compaction_latch_;
+  std::thread compaction_thread_;
+  std::mutex stop_latch_;
+  std::condition_variable stop_cv_;
+  bool stop_{false};
+};
+
+}  // namespace bustub
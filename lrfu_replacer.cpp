@@ -0,0 +1,74 @@
+#include "buffer/lrfu_replacer.h"
+
+#include <cmath>
+
+namespace bustub {
+
+LRFUReplacer::LRFUReplacer(size_t num_frames, double lambda)
+    : replacer_size_(num_frames), lambda_(lambda), frames_(num_frames) {
+  BUSTUB_ASSERT(lambda >= 0 && lambda <= 1, "lambda must be in [0, 1]");
+}
+
+auto LRFUReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::lock_guard<std::mutex> guard(latch_);
+  if (order_.empty()) {
+    return false;
+  }
+  frame_id_t victim = order_.begin()->second;
+  order_.erase(order_.begin());
+  frames_[victim] = FrameState{};
+  *frame_id = victim;
+  return true;
+}
+
+void LRFUReplacer::RecordAccess(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  FrameState &frame = frames_[frame_id];
+  size_t now = current_timestamp_++;
+  if (frame.evictable_) {
+    order_.erase({frame.key_, frame_id});
+  }
+  // 旧的 CRF 按经过的时间衰减后再加上本次访问的贡献 F(0) = 1
+  double decayed = frame.tracked_ ? frame.crf_ * std::exp2(-lambda_ * static_cast<double>(now - frame.last_)) : 0;
+  frame.tracked_ = true;
+  frame.crf_ = 1 + decayed;
+  frame.last_ = now;
+  frame.key_ = std::log2(frame.crf_) + lambda_ * static_cast<double>(now);
+  if (frame.evictable_) {
+    order_.insert({frame.key_, frame_id});
+  }
+}
+
+void LRFUReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::lock_guard<std::mutex> guard(latch_);
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  FrameState &frame = frames_[frame_id];
+  if (!frame.tracked_ || frame.evictable_ == set_evictable) {
+    return;
+  }
+  frame.evictable_ = set_evictable;
+  if (set_evictable) {
+    order_.insert({frame.key_, frame_id});
+  } else {
+    order_.erase({frame.key_, frame_id});
+  }
+}
+
+void LRFUReplacer::Remove(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  FrameState &frame = frames_[frame_id];
+  if (!frame.tracked_ || !frame.evictable_) {
+    return;
+  }
+  order_.erase({frame.key_, frame_id});
+  frame = FrameState{};
+}
+
+auto LRFUReplacer::Size() -> size_t {
+  std::lock_guard<std::mutex> guard(latch_);
+  return order_.size();
+}
+
+}  // namespace bustub
@@ -0,0 +1,108 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lrfu_replacer.h
+//
+// Identification: src/include/buffer/lrfu_replacer.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * LRFUReplacer implements the LRFU (least recently/frequently used) replacement policy.
+ *
+ * Every access contributes (1/2)^(lambda * age) to a frame's combined recency-frequency (CRF) value, and the
+ * frame with the smallest CRF is evicted. lambda = 0 counts every access equally (LFU), lambda = 1 lets the
+ * most recent access outweigh all older ones (LRU), and values in between blend the two.
+ *
+ * The CRF is updated incrementally on access: crf = 1 + crf * (1/2)^(lambda * (now - last)). Since all CRF
+ * values decay at the same rate, the order between two frames never changes until one of them is accessed,
+ * so evictable frames are kept in a std::set ordered by log2(crf) + lambda * last, giving O(log n) updates.
+ */
+class LRFUReplacer {
+ public:
+  /**
+   * Constructor for LRFUReplacer.
+   *
+   * @param num_frames the maximum number of frames the LRFUReplacer will be required to store
+   * @param lambda decay rate in [0, 1]; 0 behaves like LFU, 1 like LRU
+   */
+  LRFUReplacer(size_t num_frames, double lambda);
+
+  DISALLOW_COPY_AND_MOVE(LRFUReplacer);
+
+  /**
+   * Destroys the LRFUReplacer.
+   */
+  ~LRFUReplacer() = default;
+
+  /**
+   * Find the evictable frame with the smallest CRF value and evict it.
+   *
+   * @param[out] frame_id id of frame that is evicted.
+   * @return true if a frame is evicted successfully, false if no frames can be evicted.
+   */
+  auto Evict(frame_id_t *frame_id) -> bool;
+
+  /**
+   * Record the event that the given frame id is accessed at current timestamp and update its CRF.
+   *
+   * @param frame_id id of frame that received a new access.
+   */
+  void RecordAccess(frame_id_t frame_id);
+
+  /**
+   * Toggle whether a frame is evictable or non-evictable.
+   *
+   * @param frame_id id of frame whose 'evictable' status will be modified
+   * @param set_evictable whether the given frame is evictable or not
+   */
+  void SetEvictable(frame_id_t frame_id, bool set_evictable);
+
+  /**
+   * Remove an evictable frame from replacer, along with its CRF.
+   *
+   * @param frame_id id of frame to be removed
+   */
+  void Remove(frame_id_t frame_id);
+
+  /**
+   * Return replacer's size, which tracks the number of evictable frames.
+   *
+   * @return size_t
+   */
+  auto Size() -> size_t;
+
+ private:
+  /** Per-frame state. */
+  struct FrameState {
+    bool tracked_{false};
+    bool evictable_{false};
+    double crf_{0};     // CRF value as of the last access
+    size_t last_{0};    // timestamp of the last access
+    double key_{0};     // log2(crf_) + lambda * last_, the eviction order
+  };
+
+  size_t replacer_size_;
+  double lambda_;
+  size_t current_timestamp_{0};
+  std::vector<FrameState> frames_;
+  std::set<std::pair<double, frame_id_t>> order_;  // evictable frames, smallest CRF first
+  std::mutex latch_;
+};
+
+}  // namespace bustub
@@ -1,11 +1,32 @@
 #include "buffer/lru_k_replacer.h"
 
+#include <algorithm>
+
+#include "buffer/shadow_policy_evaluator.h"
+
 namespace bustub {
 
-LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k) : replacer_size_(num_frames), k_(k) {}
+LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k, size_t epoch_width)
+    : replacer_size_(num_frames), k_(k), hint_lists_(2 * num_frames + 1), epoch_width_(epoch_width) {
+  // A loop group has at least one member, so there are never more groups than frames
+  for (size_t i = num_frames; i > 0; i--) {
+    free_loop_sentinels_.push_back(DoneSentinel() + i);
+  }
+  if (epoch_width_ == 0) {
+    return;
+  }
+  frames_.resize(num_frames);
+  for (auto &frame : frames_) {
+    frame.history_.resize(k_);
+  }
+  lists_ = IntrusiveLists(num_frames + EPOCH_SLOTS + 1);
+}
 
 auto LRUKReplacer::Evict(frame_id_t *frame_id) -> bool {
   std::lock_guard<std::mutex> guard(latch_);
+  if (epoch_width_ != 0) {
+    return EvictEpoch(frame_id);
+  }
   frame_id_t victim_id = -1;
   size_t max_backward_distance = std::numeric_limits<size_t>::min();  // 初始化为最小值
   size_t latest_access_time = std::numeric_limits<size_t>::max();      // 初始化为最大值
@@ -70,11 +91,17 @@ auto LRUKReplacer::Evict(frame_id_t *frame_id) -> bool {
     return false;
   }
 
-  // 5. 驱逐选择的页面
+  // 5. 驱逐选择的页面（执行器提示可能换成另一个页面）
+  victim_id = HintedVictim(victim_id);
+  ClearHints(victim_id);
   *frame_id = victim_id;
   // std::cout << "Evicting Frame: " << victim_id << std::endl;
 
   // 驱逐后更新状态：从访问历史中删除，设置不可驱逐
+  RememberEviction(victim_id);
+  if (access_history_[victim_id].size() >= k_) {
+    active_frames_--;
+  }
   access_history_.erase(victim_id);
   evictable_[victim_id] = false;
   curr_size_--;
@@ -83,23 +110,47 @@ auto LRUKReplacer::Evict(frame_id_t *frame_id) -> bool {
 }
 
 
-void LRUKReplacer::RecordAccess(frame_id_t frame_id) {
-  std::lock_guard<std::mutex> guard(latch_);
-
-  // Check if the frame exists in access history
-  if (access_history_.find(frame_id) == access_history_.end()) {
-    access_history_[frame_id] = {};
-  }
+void LRUKReplacer::RecordAccess(frame_id_t frame_id, page_id_t page_id) {
+  // 帧已有访问历史说明页面本来就在缓冲池中，即一次命中
+  bool live_hit;
+  {
+    std::lock_guard<std::mutex> guard(latch_);
+    ClearDone(frame_id);
+    if (epoch_width_ != 0) {
+      live_hit = RecordAccessEpoch(frame_id, page_id);
+    } else {
+      // Check if the frame exists in access history
+      live_hit = access_history_.find(frame_id) != access_history_.end();
+      if (!live_hit) {
+        access_history_[frame_id] = {};
+        if (IsActivatedRefault(frame_id, page_id)) {
+          // 很快又被访问回来的页面直接进入 k 次历史类
+          access_history_[frame_id].assign(k_ - 1, current_timestamp_);
+        }
+      }
 
-  // Record the current timestamp in the frame's access history
-  access_history_[frame_id].push_back(current_timestamp_);
+      // Record the current timestamp in the frame's access history
+      access_history_[frame_id].push_back(current_timestamp_);
+      if (access_history_[frame_id].size() == k_) {
+        active_frames_++;
+      }
 
-  // Increment the timestamp
-  current_timestamp_++;
+      // Increment the timestamp
+      current_timestamp_++;
+    }
+    RelinkHints(frame_id);
+  }
+  if (shadow_ != nullptr) {
+    shadow_->RecordAccess(page_id, live_hit);
+  }
 }
 
 void LRUKReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
   std::lock_guard<std::mutex> guard(latch_);
+  if (epoch_width_ != 0) {
+    SetEvictableEpoch(frame_id, set_evictable);
+    return;
+  }
 
   // 只有当页面仍然存在并且未被删除时才进行设置
   if (access_history_.find(frame_id) == access_history_.end()) {
@@ -116,6 +167,7 @@ void LRUKReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
     } else {
       curr_size_--;  // 页面设置为不可驱逐时，减少计数
     }
+    RelinkHints(frame_id);
   }
   
   // 调试输出 evictable_ 和 current size
@@ -129,11 +181,20 @@ void LRUKReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
 
 void LRUKReplacer::Remove(frame_id_t frame_id) {
   std::lock_guard<std::mutex> guard(latch_);
-  
+  if (epoch_width_ != 0) {
+    RemoveEpoch(frame_id);
+    return;
+  }
+
   // 只在页面存在且是可驱逐时进行删除
   if (access_history_.find(frame_id) != access_history_.end() && evictable_[frame_id]) {
     //std::cout << "Removing frame " << frame_id << std::endl;
+    if (access_history_[frame_id].size() >= k_) {
+      active_frames_--;
+    }
     access_history_.erase(frame_id);  // 删除页面的访问历史记录
+    frame_pages_.erase(frame_id);
+    ClearHints(frame_id);
     evictable_[frame_id] = false;  // 设置页面为不可驱逐
     curr_size_--;  // 调整当前可驱逐页面的数量
   }
@@ -150,7 +211,10 @@ void LRUKReplacer::Remove(frame_id_t frame_id) {
 
 auto LRUKReplacer::Size() -> size_t {
   std::lock_guard<std::mutex> guard(latch_);
-  
+  if (epoch_width_ != 0) {
+    return curr_size_;
+  }
+
   size_t count = 0;
   for (const auto& entry : evictable_) {
     if (entry.second) {
@@ -162,6 +226,306 @@ auto LRUKReplacer::Size() -> size_t {
   return count;
 }
 
+//===--------------------------------------------------------------------===//
+// Epoch mode
+//===--------------------------------------------------------------------===//
+void LRUKReplacer::Enqueue(frame_id_t frame_id) {
+  const EpochFrame &frame = frames_[frame_id];
+  if (frame.accesses_ < k_) {
+    lists_.LinkBefore(frame_id, FifoSentinel());
+    return;
+  }
+  size_t epoch = frame.history_[(frame.accesses_ - k_) % k_] / epoch_width_;
+
+  // 时间超出轮子范围时，把最旧的几个 epoch 依次并入下一个 epoch 的前部，再复用它们的槽
+  for (size_t steps = 0; epoch >= base_epoch_ + EPOCH_SLOTS && steps + 1 < EPOCH_SLOTS; steps++) {
+    lists_.SpliceFront(SlotSentinel(base_epoch_), SlotSentinel(base_epoch_ + 1));
+    base_epoch_++;
+  }
+  if (epoch >= base_epoch_ + EPOCH_SLOTS) {
+    // Every older frame is in one slot by now; after a long gap just move that slot to the new window start
+    size_t new_base = epoch - EPOCH_SLOTS + 1;
+    lists_.SpliceFront(SlotSentinel(base_epoch_), SlotSentinel(new_base));
+    base_epoch_ = new_base;
+  }
+
+  // k-th access older than the wheel: queue it with the oldest epoch. Appending keeps the merged slot roughly
+  // in access order; putting it in front instead cost up to 8% hit ratio in trace simulations.
+  lists_.LinkBefore(frame_id, SlotSentinel(std::max(epoch, base_epoch_)));
+}
+
+auto LRUKReplacer::EvictEpoch(frame_id_t *frame_id) -> bool {
+  size_t victim = FifoSentinel();
+  if (!lists_.IsEmpty(victim)) {
+    victim = lists_.Front(victim);
+  } else {
+    for (size_t i = 0; i < EPOCH_SLOTS; i++) {
+      size_t sentinel = SlotSentinel(base_epoch_ + i);
+      if (!lists_.IsEmpty(sentinel)) {
+        victim = lists_.Front(sentinel);
+        break;
+      }
+    }
+  }
+  if (victim >= replacer_size_) {
+    return false;
+  }
+  victim = HintedVictim(static_cast<frame_id_t>(victim));
+  ClearHints(static_cast<frame_id_t>(victim));
+  lists_.Unlink(victim);
+  RememberEviction(static_cast<frame_id_t>(victim));
+  if (frames_[victim].accesses_ >= k_) {
+    active_frames_--;
+  }
+  frames_[victim].accesses_ = 0;
+  frames_[victim].evictable_ = false;
+  curr_size_--;
+  *frame_id = static_cast<frame_id_t>(victim);
+  return true;
+}
+
+auto LRUKReplacer::RecordAccessEpoch(frame_id_t frame_id, page_id_t page_id) -> bool {
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  EpochFrame &frame = frames_[frame_id];
+  bool seen = frame.accesses_ > 0;
+  if (!seen && IsActivatedRefault(frame_id, page_id)) {
+    std::fill(frame.history_.begin(), frame.history_.end(), current_timestamp_);
+    frame.accesses_ = k_ - 1;
+  }
+  frame.history_[frame.accesses_ % k_] = current_timestamp_++;
+  frame.accesses_++;
+  if (frame.accesses_ == k_) {
+    active_frames_++;
+  }
+  // A frame with fewer than k accesses keeps its FIFO position, i.e. is ordered by its earliest access
+  if (frame.evictable_ && frame.accesses_ >= k_) {
+    lists_.Unlink(frame_id);
+    Enqueue(frame_id);
+  }
+  return seen;
+}
+
+void LRUKReplacer::SetEvictableEpoch(frame_id_t frame_id, bool set_evictable) {
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  EpochFrame &frame = frames_[frame_id];
+  if (frame.accesses_ == 0 || frame.evictable_ == set_evictable) {
+    return;
+  }
+  frame.evictable_ = set_evictable;
+  if (set_evictable) {
+    Enqueue(frame_id);
+    curr_size_++;
+  } else {
+    lists_.Unlink(frame_id);
+    curr_size_--;
+  }
+  RelinkHints(frame_id);
+}
+
+void LRUKReplacer::RemoveEpoch(frame_id_t frame_id) {
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  EpochFrame &frame = frames_[frame_id];
+  if (frame.accesses_ == 0 || !frame.evictable_) {
+    return;
+  }
+  lists_.Unlink(frame_id);
+  frame_pages_.erase(frame_id);
+  ClearHints(frame_id);
+  if (frame.accesses_ >= k_) {
+    active_frames_--;
+  }
+  frame.accesses_ = 0;
+  frame.evictable_ = false;
+  curr_size_--;
+}
+
+//===--------------------------------------------------------------------===//
+// Refault detection
+//===--------------------------------------------------------------------===//
+void LRUKReplacer::EnableRefaultDetection(bool enable) {
+  std::lock_guard<std::mutex> guard(latch_);
+  refault_detection_ = enable;
+  if (!enable) {
+    frame_pages_.clear();
+  }
+  shadow_entries_.clear();
+  shadow_ring_.assign(enable ? replacer_size_ : 0, INVALID_PAGE_ID);
+}
+
+auto LRUKReplacer::GetNumActivatedRefaults() -> uint64_t {
+  std::lock_guard<std::mutex> guard(latch_);
+  return activated_refaults_;
+}
+
+void LRUKReplacer::RememberEviction(frame_id_t frame_id) {
+  if (shadow_ring_.empty()) {
+    return;
+  }
+  // 页号未知的帧也要计入驱逐次数，否则重新载入的距离会被低估；它只在环中占一个空位
+  page_id_t page_id = INVALID_PAGE_ID;
+  auto it = frame_pages_.find(frame_id);
+  if (it != frame_pages_.end()) {
+    page_id = it->second;
+    frame_pages_.erase(it);
+  }
+  // 环中被覆盖的旧条目距离已达 replacer_size_，不可能再通过距离检查，直接丢弃
+  size_t slot = evictions_ % shadow_ring_.size();
+  page_id_t expired = shadow_ring_[slot];
+  if (expired != INVALID_PAGE_ID) {
+    auto entry = shadow_entries_.find(expired);
+    if (entry != shadow_entries_.end() && entry->second + shadow_ring_.size() == evictions_) {
+      shadow_entries_.erase(entry);
+    }
+  }
+  shadow_ring_[slot] = page_id;
+  if (page_id != INVALID_PAGE_ID) {
+    shadow_entries_[page_id] = evictions_;
+  }
+  evictions_++;
+}
+
+auto LRUKReplacer::IsActivatedRefault(frame_id_t frame_id, page_id_t page_id) -> bool {
+  if (!refault_detection_ || page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  frame_pages_[frame_id] = page_id;
+  auto entry = shadow_entries_.find(page_id);
+  if (entry == shadow_entries_.end()) {
+    return false;
+  }
+  uint64_t distance = evictions_ - entry->second;
+  shadow_entries_.erase(entry);
+  if (distance >= frame_pages_.size() || k_ < 2 || active_frames_ >= replacer_size_ - replacer_size_ / 8) {
+    return false;
+  }
+  activated_refaults_++;
+  return true;
+}
+
+//===--------------------------------------------------------------------===//
+// Executor hints
+//===--------------------------------------------------------------------===//
+void LRUKReplacer::HintDone(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  if (!IsTracked(frame_id) || !done_frames_.insert(frame_id).second) {
+    return;
+  }
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  RelinkHints(frame_id);
+}
+
+auto LRUKReplacer::HintLoop(const std::vector<frame_id_t> &frames, size_t group) -> size_t {
+  std::lock_guard<std::mutex> guard(latch_);
+  if (group == NEW_LOOP_GROUP) {
+    group = next_loop_group_++;
+  }
+  for (frame_id_t frame_id : frames) {
+    if (!IsTracked(frame_id)) {
+      continue;
+    }
+    BUSTUB_ASSERT(static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+    auto it = frame_loop_.find(frame_id);
+    if (it != frame_loop_.end() && it->second == group) {
+      continue;
+    }
+    ClearLoop(frame_id);
+    auto entry = loop_groups_.find(group);
+    if (entry == loop_groups_.end()) {
+      entry = loop_groups_.emplace(group, LoopGroup{free_loop_sentinels_.back()}).first;
+      free_loop_sentinels_.pop_back();
+    }
+    entry->second.members_++;
+    frame_loop_[frame_id] = group;
+    RelinkHints(frame_id);
+  }
+  return group;
+}
+
+auto LRUKReplacer::IsTracked(frame_id_t frame_id) const -> bool {
+  if (epoch_width_ != 0) {
+    return static_cast<size_t>(frame_id) < replacer_size_ && frames_[frame_id].accesses_ > 0;
+  }
+  return access_history_.find(frame_id) != access_history_.end();
+}
+
+auto LRUKReplacer::IsEvictableFrame(frame_id_t frame_id) const -> bool {
+  if (epoch_width_ != 0) {
+    return frames_[frame_id].evictable_;
+  }
+  auto it = evictable_.find(frame_id);
+  return it != evictable_.end() && it->second;
+}
+
+auto LRUKReplacer::LastAccess(frame_id_t frame_id) const -> size_t {
+  if (epoch_width_ != 0) {
+    const EpochFrame &frame = frames_[frame_id];
+    return frame.history_[(frame.accesses_ - 1) % k_];
+  }
+  return access_history_.at(frame_id).back();
+}
+
+auto LRUKReplacer::HintedVictim(frame_id_t victim) const -> frame_id_t {
+  // 标记为不再需要的帧最先驱逐；done 链表里只有可驱逐的帧
+  if (!hint_lists_.IsEmpty(DoneSentinel())) {
+    return static_cast<frame_id_t>(hint_lists_.Front(DoneSentinel()));
+  }
+  auto it = frame_loop_.find(victim);
+  if (it == frame_loop_.end()) {
+    return victim;
+  }
+  // 循环组内按 MRU 驱逐：组链表的队首就是最近访问过的可驱逐帧，victim 自己也在其中
+  return static_cast<frame_id_t>(hint_lists_.Front(loop_groups_.at(it->second).sentinel_));
+}
+
+void LRUKReplacer::RelinkHints(frame_id_t frame_id) {
+  bool done = done_frames_.count(frame_id) != 0;
+  auto it = frame_loop_.find(frame_id);
+  if (!done && it == frame_loop_.end()) {
+    return;  // frames without hints are never linked
+  }
+  hint_lists_.Unlink(frame_id);
+  if (!IsEvictableFrame(frame_id)) {
+    return;
+  }
+  if (done) {
+    hint_lists_.LinkBefore(frame_id, DoneSentinel());
+    return;
+  }
+  // Keep the group sorted by last access. A frame that was just accessed or unpinned is usually the most
+  // recent one, so the walk stops at or near the front.
+  size_t sentinel = loop_groups_.at(it->second).sentinel_;
+  size_t pos = hint_lists_.Front(sentinel);
+  while (pos != sentinel && LastAccess(static_cast<frame_id_t>(pos)) > LastAccess(frame_id)) {
+    pos = hint_lists_.Next(pos);
+  }
+  hint_lists_.LinkBefore(frame_id, pos);
+}
+
+void LRUKReplacer::ClearDone(frame_id_t frame_id) {
+  if (done_frames_.erase(frame_id) != 0) {
+    hint_lists_.Unlink(frame_id);
+  }
+}
+
+void LRUKReplacer::ClearLoop(frame_id_t frame_id) {
+  auto it = frame_loop_.find(frame_id);
+  if (it == frame_loop_.end()) {
+    return;
+  }
+  hint_lists_.Unlink(frame_id);
+  auto group = loop_groups_.find(it->second);
+  if (--group->second.members_ == 0) {
+    free_loop_sentinels_.push_back(group->second.sentinel_);
+    loop_groups_.erase(group);
+  }
+  frame_loop_.erase(it);
+}
+
+void LRUKReplacer::ClearHints(frame_id_t frame_id) {
+  ClearDone(frame_id);
+  ClearLoop(frame_id);
+}
+
 
 
 
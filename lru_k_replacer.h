@@ -13,17 +13,20 @@
 #pragma once
 
 #include <limits>
-#include <list>
 #include <mutex>  // NOLINT
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include<iostream>
 
+#include "buffer/intrusive_lists.h"
 #include "common/config.h"
 #include "common/macros.h"
 
 namespace bustub {
 
+class ShadowPolicyEvaluator;
+
 /**
  * LRUKReplacer implements the LRU-k replacement policy.
  *
@@ -34,16 +37,26 @@ namespace bustub {
  * A frame with less than k historical references is given
  * +inf as its backward k-distance. When multiple frames have +inf backward k-distance,
  * classical LRU algorithm is used to choose victim.
+ *
+ * With a non-zero epoch_width the replacer runs in an approximate O(1) mode instead of scanning every frame
+ * on Evict. Evictable frames with fewer than k accesses wait in a FIFO. The others sit in a timing wheel of
+ * EPOCH_SLOTS intrusive lists, one per epoch of epoch_width timestamps, chosen by their k-th most recent
+ * access. RecordAccess moves a frame between lists in O(1) and Evict takes the front of the FIFO, or else of
+ * the oldest non-empty epoch, so frames whose k-th access falls into the same epoch are not ordered exactly.
+ * When time runs past the wheel, the oldest epochs are spliced into one slot, which then behaves like a FIFO.
  */
 class LRUKReplacer {
  public:
+  static constexpr size_t NEW_LOOP_GROUP = std::numeric_limits<size_t>::max();
+
   /**
    * Constructor for LRUKReplacer.
    *
    * @param num_frames the maximum number of frames the LRUReplacer will be required to store
    * @param k the history length for LRU-K
+   * @param epoch_width timestamps per epoch of the approximate mode, or 0 for exact LRU-K
    */
-  explicit LRUKReplacer(size_t num_frames, size_t k);
+  explicit LRUKReplacer(size_t num_frames, size_t k, size_t epoch_width = 0);
 
   DISALLOW_COPY_AND_MOVE(LRUKReplacer);
 
@@ -66,8 +79,11 @@ class LRUKReplacer {
    * Create a new entry for access history if frame id has not been seen before.
    *
    * @param frame_id id of frame that received a new access.
+   * @param page_id page held by the frame; mirrored to the attached shadow evaluator if any, and used to detect
+   * refaults when refault detection is enabled. Frames recorded without a page id still count as evictions for
+   * the refault distance, but are never activated themselves.
    */
-  void RecordAccess(frame_id_t frame_id);
+  void RecordAccess(frame_id_t frame_id, page_id_t page_id = INVALID_PAGE_ID);
 
   /**
    * Toggle whether a frame is evictable or non-evictable.
@@ -91,6 +107,55 @@ class LRUKReplacer {
    */
   auto Size() -> size_t;
 
+  /**
+   * Mirror every access into a shadow evaluator, which compares other policies with this one. Must be
+   * called before the replacer is shared between threads.
+   *
+   * @param evaluator the evaluator, or nullptr to detach; it must outlive the replacer
+   */
+  void AttachShadowEvaluator(ShadowPolicyEvaluator *evaluator) { shadow_ = evaluator; }
+
+  /**
+   * Detect pages that come back soon after being evicted (Linux-style refault distance). Every eviction is
+   * counted, and evicting a frame whose page id was passed to RecordAccess leaves a shadow entry with the
+   * eviction count. When the page is loaded again, the refault distance is the number of evictions since; if
+   * it is smaller than the number of resident frames with a known page, the page would have stayed in a pool
+   * of less than twice the size, so the frame starts with k accesses instead of one and skips the +inf class
+   * that is evicted first. Activation stops while the k-history class holds 7/8 of the frames, so that the
+   * +inf class keeps room to cycle new pages through instead of pushing out the activated ones.
+   *
+   * @param enable whether to detect refaults
+   */
+  void EnableRefaultDetection(bool enable = true);
+
+  /** @brief Get the number of loads that were admitted straight into the k-history class. */
+  auto GetNumActivatedRefaults() -> uint64_t;
+
+  /**
+   * Hint that the page in a frame will not be read again, e.g. at the end of a one-pass scan. The frame is
+   * evicted before any frame the policy would choose, as soon as it is evictable. The hint lasts until the
+   * frame is accessed again, evicted or removed; frames the replacer does not track are ignored.
+   *
+   * @param frame_id id of the frame that is no longer needed
+   */
+  void HintDone(frame_id_t frame_id);
+
+  /**
+   * Hint that the pages in some frames are re-read in a loop, e.g. the inner side of a nested-loop join.
+   * When the policy picks a victim from the group, the most recently used evictable frame of the group is
+   * evicted instead. LRU keeps evicting exactly the page the loop needs next once the loop is larger than
+   * the pool, while MRU keeps a fixed part of the loop resident and hits on it in every pass.
+   *
+   * The frames leave any group they were in before; a frame stays in its group until it is evicted or
+   * removed, so frames that are loaded while the loop runs have to be added as well. Frames the replacer
+   * does not track are ignored.
+   *
+   * @param frames ids of the frames that hold pages of the loop
+   * @param group group returned by an earlier call to add the frames to, or NEW_LOOP_GROUP
+   * @return the group of the frames
+   */
+  auto HintLoop(const std::vector<frame_id_t> &frames, size_t group = NEW_LOOP_GROUP) -> size_t;
+
  private:
   // Frame access history: stores the timestamps of access for each frame
   std::unordered_map<frame_id_t, std::vector<size_t>> access_history_;
@@ -110,6 +175,80 @@ class LRUKReplacer {
 
   // Mutex for thread-safety
   std::mutex latch_;
+
+  ShadowPolicyEvaluator *shadow_{nullptr};
+
+  bool refault_detection_{false};
+  size_t active_frames_{0};  // frames with at least k accesses
+  uint64_t evictions_{0};
+  uint64_t activated_refaults_{0};
+  std::unordered_map<frame_id_t, page_id_t> frame_pages_;  // resident frames whose page id is known
+  // Shadow entries: page id -> eviction count when it was evicted, for the last replacer_size_ evictions
+  std::unordered_map<page_id_t, uint64_t> shadow_entries_;
+  std::vector<page_id_t> shadow_ring_;  // page evicted by eviction i is at i % replacer_size_
+
+  /** @brief Leave a shadow entry for the page of a frame that is being evicted. */
+  void RememberEviction(frame_id_t frame_id);
+  /** @brief Record the page a fresh frame now holds; whether it is a refault that should be activated. */
+  auto IsActivatedRefault(frame_id_t frame_id, page_id_t page_id) -> bool;
+
+  // Executor hints
+  struct LoopGroup {
+    size_t sentinel_;  // list of the evictable members in hint_lists_, most recently used first
+    size_t members_{0};
+  };
+
+  std::unordered_set<frame_id_t> done_frames_;  // frames hinted as done
+  std::unordered_map<size_t, LoopGroup> loop_groups_;
+  std::unordered_map<frame_id_t, size_t> frame_loop_;  // frame -> its loop group
+  size_t next_loop_group_{0};
+  std::vector<size_t> free_loop_sentinels_;
+  // Evictable hinted frames: frames, then the done sentinel, then one sentinel per loop group. Done frames are
+  // queued in the order they became evictable.
+  IntrusiveLists hint_lists_;
+
+  auto IsTracked(frame_id_t frame_id) const -> bool;
+  auto IsEvictableFrame(frame_id_t frame_id) const -> bool;
+  auto LastAccess(frame_id_t frame_id) const -> size_t;
+  /** @brief Apply the hints to the victim chosen by the policy; the result is evictable as well. */
+  auto HintedVictim(frame_id_t victim) const -> frame_id_t;
+  auto DoneSentinel() const -> size_t { return replacer_size_; }
+  /** @brief Put a hinted frame into the hint list it belongs to now, or into none if it is not evictable. */
+  void RelinkHints(frame_id_t frame_id);
+  void ClearDone(frame_id_t frame_id);
+  void ClearLoop(frame_id_t frame_id);
+  /** @brief Drop every hint on a frame that leaves the replacer. */
+  void ClearHints(frame_id_t frame_id);
+
+  static constexpr size_t EPOCH_SLOTS = 64;
+
+  /** Per-frame state of the epoch mode. */
+  struct EpochFrame {
+    std::vector<size_t> history_;  // the last k access timestamps; access number i is at i % k
+    size_t accesses_{0};
+    bool evictable_{false};
+  };
+
+  size_t epoch_width_;
+  std::vector<EpochFrame> frames_;
+  IntrusiveLists lists_;  // frames, then one sentinel per wheel slot, then the FIFO sentinel
+  size_t base_epoch_{0};  // oldest epoch the wheel covers; it covers EPOCH_SLOTS epochs
+
+  /*****************************************************************
+   * Must acquire latch_ first before calling the below functions. *
+   *****************************************************************/
+
+  auto SlotSentinel(size_t epoch) const -> size_t { return replacer_size_ + epoch % EPOCH_SLOTS; }
+  auto FifoSentinel() const -> size_t { return replacer_size_ + EPOCH_SLOTS; }
+
+  /** @brief Put an evictable frame into the FIFO or into the wheel slot of its k-th most recent access. */
+  void Enqueue(frame_id_t frame_id);
+
+  auto EvictEpoch(frame_id_t *frame_id) -> bool;
+  /** @return whether the frame had been accessed before */
+  auto RecordAccessEpoch(frame_id_t frame_id, page_id_t page_id) -> bool;
+  void SetEvictableEpoch(frame_id_t frame_id, bool set_evictable);
+  void RemoveEpoch(frame_id_t frame_id);
 };
 
 }  // namespace bustub
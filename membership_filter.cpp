@@ -0,0 +1,186 @@
+#include "container/filter/membership_filter.h"
+
+#include <algorithm>
+#include <mutex>  // NOLINT
+
+namespace bustub {
+
+namespace {
+/** splitmix64 step, used to derive independent hash values from one key hash. */
+auto Remix(uint64_t x) -> uint64_t {
+  x += 0x9E3779B97F4A7C15ULL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+}  // namespace
+
+//===--------------------------------------------------------------------===//
+// BlockedBloomFilter
+//===--------------------------------------------------------------------===//
+BlockedBloomFilter::BlockedBloomFilter(size_t expected_keys, size_t bits_per_key)
+    : num_blocks_(std::max<size_t>(1, (expected_keys * bits_per_key + 511) / 512)),
+      words_(new std::atomic<uint64_t>[num_blocks_ * BLOCK_WORDS]) {
+  for (size_t i = 0; i < num_blocks_ * BLOCK_WORDS; i++) {
+    words_[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+void BlockedBloomFilter::Insert(uint64_t hash) {
+  uint64_t h = Remix(hash);
+  std::atomic<uint64_t> *block = &words_[BlockOf(h) * BLOCK_WORDS];
+  // 块号只用了高 32 位，探测位从再混合一次的值派生，两者互不相关，全部落在同一个 512 位块内
+  uint64_t probe = Remix(h);
+  uint64_t step = (probe >> 32) | 1;
+  for (size_t i = 0; i < NUM_PROBES; i++) {
+    uint64_t bit = (probe + i * step) & 511;
+    block[bit >> 6].fetch_or(1ULL << (bit & 63), std::memory_order_relaxed);
+  }
+}
+
+auto BlockedBloomFilter::MayContain(uint64_t hash) const -> bool {
+  uint64_t h = Remix(hash);
+  const std::atomic<uint64_t> *block = &words_[BlockOf(h) * BLOCK_WORDS];
+  uint64_t probe = Remix(h);
+  uint64_t step = (probe >> 32) | 1;
+  for (size_t i = 0; i < NUM_PROBES; i++) {
+    uint64_t bit = (probe + i * step) & 511;
+    if ((block[bit >> 6].load(std::memory_order_relaxed) & (1ULL << (bit & 63))) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+//===--------------------------------------------------------------------===//
+// XorFilter
+//===--------------------------------------------------------------------===//
+XorFilter::XorFilter(const std::vector<uint64_t> &hashes) {
+  std::vector<uint64_t> keys(hashes);
+  std::sort(keys.begin(), keys.end());
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+  block_length_ = (32 + keys.size() * 123 / 100) / 3 + 1;
+  fingerprints_.resize(block_length_ * 3);
+  // 剥离失败的概率很小，换一个种子重试即可
+  while (!TryBuild(keys)) {
+    seed_++;
+  }
+}
+
+auto XorFilter::Mix(uint64_t hash) const -> uint64_t { return Remix(hash + seed_ * 0x9E3779B97F4A7C15ULL); }
+
+auto XorFilter::Slot(uint64_t mixed, int index) const -> size_t {
+  // Each of the three hash functions owns one third of the table
+  int shift = 21 * index;
+  uint64_t r = (mixed << shift) | (mixed >> ((64 - shift) & 63));
+  return static_cast<size_t>(index) * block_length_ +
+         static_cast<size_t>((static_cast<__uint128_t>(static_cast<uint32_t>(r)) * block_length_) >> 32);
+}
+
+auto XorFilter::TryBuild(const std::vector<uint64_t> &keys) -> bool {
+  size_t capacity = fingerprints_.size();
+  std::vector<uint64_t> xor_mask(capacity, 0);
+  std::vector<uint32_t> count(capacity, 0);
+  for (uint64_t key : keys) {
+    uint64_t mixed = Mix(key);
+    for (int i = 0; i < 3; i++) {
+      size_t slot = Slot(mixed, i);
+      xor_mask[slot] ^= mixed;
+      count[slot]++;
+    }
+  }
+
+  // Peel slots that only one key maps to; the peeling order is replayed backwards to assign fingerprints
+  std::vector<size_t> queue;
+  for (size_t slot = 0; slot < capacity; slot++) {
+    if (count[slot] == 1) {
+      queue.push_back(slot);
+    }
+  }
+  std::vector<std::pair<uint64_t, size_t>> stack;  // (mixed key, the slot it was peeled from)
+  while (!queue.empty()) {
+    size_t slot = queue.back();
+    queue.pop_back();
+    if (count[slot] != 1) {
+      continue;
+    }
+    uint64_t mixed = xor_mask[slot];
+    stack.emplace_back(mixed, slot);
+    for (int i = 0; i < 3; i++) {
+      size_t other = Slot(mixed, i);
+      xor_mask[other] ^= mixed;
+      if (--count[other] == 1) {
+        queue.push_back(other);
+      }
+    }
+  }
+  if (stack.size() != keys.size()) {
+    return false;
+  }
+
+  std::fill(fingerprints_.begin(), fingerprints_.end(), 0);
+  for (auto it = stack.rbegin(); it != stack.rend(); ++it) {
+    auto [mixed, slot] = *it;
+    uint8_t fp = Fingerprint(mixed);
+    for (int i = 0; i < 3; i++) {
+      size_t other = Slot(mixed, i);
+      if (other != slot) {
+        fp ^= fingerprints_[other];
+      }
+    }
+    fingerprints_[slot] = fp;
+  }
+  return true;
+}
+
+auto XorFilter::MayContain(uint64_t hash) const -> bool {
+  uint64_t mixed = Mix(hash);
+  return Fingerprint(mixed) ==
+         static_cast<uint8_t>(fingerprints_[Slot(mixed, 0)] ^ fingerprints_[Slot(mixed, 1)] ^
+                              fingerprints_[Slot(mixed, 2)]);
+}
+
+//===--------------------------------------------------------------------===//
+// IndexMembershipFilter
+//===--------------------------------------------------------------------===//
+IndexMembershipFilter::IndexMembershipFilter(size_t expected_mutable_keys, size_t pages_per_lookup)
+    : pages_per_lookup_(pages_per_lookup), mutable_filter_(expected_mutable_keys) {}
+
+void IndexMembershipFilter::AddStaticSegment(const std::vector<uint64_t> &hashes) {
+  auto filter = std::make_unique<XorFilter>(hashes);
+  std::unique_lock lock(latch_);
+  static_filters_.push_back(std::move(filter));
+}
+
+void IndexMembershipFilter::Insert(uint64_t hash) { mutable_filter_.Insert(hash); }
+
+auto IndexMembershipFilter::MayContain(uint64_t hash) -> bool {
+  probes_.fetch_add(1, std::memory_order_relaxed);
+  if (mutable_filter_.MayContain(hash)) {
+    return true;
+  }
+  {
+    std::shared_lock lock(latch_);
+    for (const auto &filter : static_filters_) {
+      if (filter->MayContain(hash)) {
+        return true;
+      }
+    }
+  }
+  negatives_.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+void IndexMembershipFilter::RecordFalsePositive() { false_positives_.fetch_add(1, std::memory_order_relaxed); }
+
+auto IndexMembershipFilter::GetStats() const -> MembershipFilterStats {
+  MembershipFilterStats stats;
+  stats.probes_ = probes_.load(std::memory_order_relaxed);
+  stats.negatives_ = negatives_.load(std::memory_order_relaxed);
+  stats.false_positives_ = false_positives_.load(std::memory_order_relaxed);
+  stats.saved_page_reads_ = stats.negatives_ * pages_per_lookup_;
+  return stats;
+}
+
+}  // namespace bustub
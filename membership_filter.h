@@ -0,0 +1,157 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// membership_filter.h
+//
+// Identification: src/include/container/filter/membership_filter.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+/**
+ * membership_filter.h
+ *
+ * Approximate membership filters that let a disk-backed index skip page reads for absent keys.
+ * All filters take an already computed 64-bit key hash.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * BlockedBloomFilter is a Bloom filter whose k bits for a key all fall into one 512-bit block,
+ * so a probe touches a single cache line. Inserts are lock-free and may run concurrently with probes.
+ * Keys cannot be removed; rebuild the filter (or accept a higher false-positive rate) after deletes.
+ */
+class BlockedBloomFilter {
+ public:
+  /**
+   * @param expected_keys number of keys the filter is sized for
+   * @param bits_per_key memory budget per key; 10 bits gives roughly a 1% false-positive rate
+   */
+  explicit BlockedBloomFilter(size_t expected_keys, size_t bits_per_key = 10);
+
+  /** @brief Add a key hash to the filter. */
+  void Insert(uint64_t hash);
+
+  /** @brief Return false if the key is definitely absent, true if it may be present. */
+  auto MayContain(uint64_t hash) const -> bool;
+
+  /** @brief Get the size of the filter in bytes. */
+  auto GetSizeInBytes() const -> size_t { return num_blocks_ * BLOCK_WORDS * sizeof(uint64_t); }
+
+ private:
+  static constexpr size_t BLOCK_WORDS = 8;  // 512 bits = one cache line
+  static constexpr size_t NUM_PROBES = 6;
+
+  /** @brief Pick a block from the high half of a mixed hash; the probe bits come from mixing it again. */
+  auto BlockOf(uint64_t h) const -> size_t { return ((h >> 32) * num_blocks_) >> 32; }
+
+  size_t num_blocks_;
+  std::unique_ptr<std::atomic<uint64_t>[]> words_;
+};
+
+/**
+ * XorFilter is a static filter built once from a fixed key set (Graf & Lemire). It stores one 8-bit
+ * fingerprint per ~1.23 keys and answers a probe with three memory reads, at a false-positive rate of
+ * about 0.4%. It is a good fit for index segments that no longer change.
+ */
+class XorFilter {
+ public:
+  /**
+   * @brief Build a filter over the given key hashes. Duplicate hashes are allowed.
+   * @param hashes hashes of every key in the segment
+   */
+  explicit XorFilter(const std::vector<uint64_t> &hashes);
+
+  /** @brief Return false if the key is definitely absent, true if it may be present. */
+  auto MayContain(uint64_t hash) const -> bool;
+
+  /** @brief Get the size of the filter in bytes. */
+  auto GetSizeInBytes() const -> size_t { return fingerprints_.size(); }
+
+ private:
+  /** @brief Try to build the filter with the current seed; fails if the hypergraph does not peel. */
+  auto TryBuild(const std::vector<uint64_t> &keys) -> bool;
+  auto Mix(uint64_t hash) const -> uint64_t;
+  auto Slot(uint64_t mixed, int index) const -> size_t;
+  static auto Fingerprint(uint64_t mixed) -> uint8_t { return static_cast<uint8_t>(mixed ^ (mixed >> 32)); }
+
+  uint64_t seed_{0};
+  size_t block_length_{0};
+  std::vector<uint8_t> fingerprints_;
+};
+
+/**
+ * Counters exposed by IndexMembershipFilter.
+ */
+struct MembershipFilterStats {
+  /** Lookups answered by the filter. */
+  uint64_t probes_{0};
+  /** Lookups the filter rejected, i.e. keys proven absent without touching a page. */
+  uint64_t negatives_{0};
+  /** Lookups the filter passed but the index then failed to find. */
+  uint64_t false_positives_{0};
+  /** Page reads avoided: negatives times the pages a lookup would have fetched. */
+  uint64_t saved_page_reads_{0};
+
+  /** @brief Fraction of absent keys the filter failed to reject. */
+  auto GetFalsePositiveRate() const -> double {
+    uint64_t absent = negatives_ + false_positives_;
+    return absent == 0 ? 0 : static_cast<double>(false_positives_) / static_cast<double>(absent);
+  }
+};
+
+/**
+ * IndexMembershipFilter is the in-memory filter in front of one disk-resident hash index.
+ *
+ * Static segments get an XorFilter each; keys inserted since then go into a BlockedBloomFilter. The index
+ * calls MayContain before fetching any page and, when a passed lookup finds nothing, RecordFalsePositive.
+ */
+class IndexMembershipFilter {
+ public:
+  /**
+   * @param expected_mutable_keys sizing of the Bloom filter for newly inserted keys
+   * @param pages_per_lookup pages a lookup reads through the buffer pool (directory + bucket)
+   */
+  explicit IndexMembershipFilter(size_t expected_mutable_keys, size_t pages_per_lookup = 2);
+
+  DISALLOW_COPY_AND_MOVE(IndexMembershipFilter);
+
+  /** @brief Add an xor filter covering a static segment's keys. */
+  void AddStaticSegment(const std::vector<uint64_t> &hashes);
+
+  /** @brief Record a newly inserted key. */
+  void Insert(uint64_t hash);
+
+  /** @brief Check a key before fetching pages; counts the probe and any saved page reads. */
+  auto MayContain(uint64_t hash) -> bool;
+
+  /** @brief Report that a lookup the filter passed did not find the key. */
+  void RecordFalsePositive();
+
+  /** @brief Get a snapshot of the filter's counters. */
+  auto GetStats() const -> MembershipFilterStats;
+
+ private:
+  size_t pages_per_lookup_;
+  BlockedBloomFilter mutable_filter_;
+  mutable std::shared_mutex latch_;  // protects static_filters_
+  std::vector<std::unique_ptr<XorFilter>> static_filters_;
+
+  std::atomic<uint64_t> probes_{0};
+  std::atomic<uint64_t> negatives_{0};
+  std::atomic<uint64_t> false_positives_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,277 @@
+#include "container/hash/packed_hash_table.h"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>  // NOLINT
+#include <string>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "storage/page/page.h"
+
+namespace bustub {
+
+namespace {
+constexpr size_t SIMD_BYTES = 16;
+
+auto RoundUp(size_t bytes) -> size_t { return (bytes + SIMD_BYTES - 1) / SIMD_BYTES * SIMD_BYTES; }
+}  // namespace
+
+template <typename K, typename V>
+PackedHashTable<K, V>::PackedHashTable(size_t bucket_size) : bucket_size_(bucket_size) {
+  auto bucket = std::make_shared<Bucket>();
+  Encode(bucket.get(), {});
+  dir_.push_back(std::move(bucket));
+}
+
+template <typename K, typename V>
+auto PackedHashTable<K, V>::GetGlobalDepth() const -> int {
+  std::shared_lock lock(latch_);
+  return global_depth_;
+}
+
+template <typename K, typename V>
+auto PackedHashTable<K, V>::GetNumBuckets() const -> int {
+  std::shared_lock lock(latch_);
+  return num_buckets_;
+}
+
+template <typename K, typename V>
+auto PackedHashTable<K, V>::GetBytesPerEntry() const -> double {
+  std::shared_lock lock(latch_);
+  if (size_ == 0) {
+    return 0;
+  }
+  size_t bytes = dir_.size() * sizeof(std::shared_ptr<Bucket>);
+  for (size_t i = 0; i < dir_.size(); i++) {
+    const Bucket &bucket = *dir_[i];
+    // 每个桶只在第一个指向它的目录项处计一次
+    if (i == bucket.pattern_) {
+      bytes += sizeof(Bucket) + bucket.packed_.capacity() + bucket.values_.capacity() * sizeof(V);
+    }
+  }
+  return static_cast<double>(bytes) / static_cast<double>(size_);
+}
+
+template <typename K, typename V>
+auto PackedHashTable<K, V>::GetAverageProbeCost() const -> double {
+  uint64_t probes = probes_.load(std::memory_order_relaxed);
+  if (probes == 0) {
+    return 0;
+  }
+  return static_cast<double>(probe_blocks_.load(std::memory_order_relaxed)) / static_cast<double>(probes);
+}
+
+template <typename K, typename V>
+auto PackedHashTable<K, V>::Find(const K &key, V &value) -> bool {
+  std::shared_lock lock(latch_);
+  auto ukey = static_cast<uint32_t>(key);
+  const Bucket &bucket = *dir_[IndexOf(ukey)];
+  uint64_t blocks = 0;
+  int slot = Locate(bucket, ukey, &blocks);
+  probes_.fetch_add(1, std::memory_order_relaxed);
+  probe_blocks_.fetch_add(blocks, std::memory_order_relaxed);
+  if (slot < 0) {
+    return false;
+  }
+  value = bucket.values_[slot];
+  return true;
+}
+
+template <typename K, typename V>
+void PackedHashTable<K, V>::Insert(const K &key, const V &value) {
+  std::unique_lock lock(latch_);
+  auto ukey = static_cast<uint32_t>(key);
+  while (true) {
+    size_t index = IndexOf(ukey);
+    Bucket *bucket = dir_[index].get();
+    uint64_t blocks = 0;
+    int slot = Locate(*bucket, ukey, &blocks);
+    if (slot >= 0) {
+      bucket->values_[slot] = value;
+      return;
+    }
+    if (bucket->size_ < bucket_size_) {
+      uint32_t high = bucket->depth_ >= 32 ? 0 : ukey >> bucket->depth_;
+      bucket->values_.push_back(value);
+      bool fits = bucket->size_ > 0 && high >= bucket->base_ &&
+                  (bucket->width_ == 4 || ((high - bucket->base_) >> (8 * bucket->width_)) == 0);
+      if (fits) {
+        Store(bucket, bucket->size_++, ukey);
+      } else {
+        // 新键超出了当前基准或位宽，重新编码整个桶
+        std::vector<uint32_t> keys;
+        for (uint32_t i = 0; i < bucket->size_; i++) {
+          keys.push_back(KeyAt(*bucket, i));
+        }
+        keys.push_back(ukey);
+        Encode(bucket, keys);
+      }
+      size_++;
+      return;
+    }
+    SplitBucket(index);
+  }
+}
+
+template <typename K, typename V>
+auto PackedHashTable<K, V>::Remove(const K &key) -> bool {
+  std::unique_lock lock(latch_);
+  auto ukey = static_cast<uint32_t>(key);
+  Bucket *bucket = dir_[IndexOf(ukey)].get();
+  uint64_t blocks = 0;
+  int slot = Locate(*bucket, ukey, &blocks);
+  if (slot < 0) {
+    return false;
+  }
+  // Move the last entry into the hole; the remaining keys still fit the current base and width
+  uint32_t last = bucket->size_ - 1;
+  memcpy(&bucket->packed_[slot * bucket->width_], &bucket->packed_[last * bucket->width_], bucket->width_);
+  memset(&bucket->packed_[last * bucket->width_], 0, bucket->width_);
+  bucket->values_[slot] = std::move(bucket->values_[last]);
+  bucket->values_.pop_back();
+  bucket->size_--;
+  size_--;
+  return true;
+}
+
+template <typename K, typename V>
+auto PackedHashTable<K, V>::Locate(const Bucket &bucket, uint32_t key, uint64_t *blocks) -> int {
+  uint32_t high = bucket.depth_ >= 32 ? 0 : key >> bucket.depth_;
+  if (bucket.size_ == 0 || high < bucket.base_) {
+    return -1;
+  }
+  uint32_t delta = high - bucket.base_;
+  if (bucket.width_ < 4 && (delta >> (8 * bucket.width_)) != 0) {
+    return -1;
+  }
+  size_t bytes = static_cast<size_t>(bucket.size_) * bucket.width_;
+#ifdef __SSE2__
+  __m128i needle;
+  if (bucket.width_ == 1) {
+    needle = _mm_set1_epi8(static_cast<char>(delta));
+  } else if (bucket.width_ == 2) {
+    needle = _mm_set1_epi16(static_cast<int16_t>(delta));
+  } else {
+    needle = _mm_set1_epi32(static_cast<int32_t>(delta));
+  }
+  for (size_t offset = 0; offset < bytes; offset += SIMD_BYTES) {
+    (*blocks)++;
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bucket.packed_.data() + offset));
+    __m128i eq;
+    if (bucket.width_ == 1) {
+      eq = _mm_cmpeq_epi8(block, needle);
+    } else if (bucket.width_ == 2) {
+      eq = _mm_cmpeq_epi16(block, needle);
+    } else {
+      eq = _mm_cmpeq_epi32(block, needle);
+    }
+    auto mask = static_cast<uint32_t>(_mm_movemask_epi8(eq));
+    // 最后一个块里超出 size_ 的填充字节可能误匹配，屏蔽掉
+    if (bytes - offset < SIMD_BYTES) {
+      mask &= (1U << (bytes - offset)) - 1;
+    }
+    if (mask != 0) {
+      return static_cast<int>((offset + __builtin_ctz(mask)) / bucket.width_);
+    }
+  }
+  return -1;
+#else
+  for (uint32_t i = 0; i < bucket.size_; i++) {
+    (*blocks)++;
+    uint32_t stored = 0;
+    memcpy(&stored, &bucket.packed_[i * bucket.width_], bucket.width_);
+    if (stored == delta) {
+      return static_cast<int>(i);
+    }
+  }
+  (void)bytes;
+  return -1;
+#endif
+}
+
+template <typename K, typename V>
+auto PackedHashTable<K, V>::KeyAt(const Bucket &bucket, uint32_t slot) -> uint32_t {
+  // Packed keys are little-endian, so copying width_ bytes into a zeroed word decodes them
+  uint32_t delta = 0;
+  memcpy(&delta, &bucket.packed_[slot * bucket.width_], bucket.width_);
+  if (bucket.depth_ >= 32) {
+    return bucket.pattern_;
+  }
+  return ((bucket.base_ + delta) << bucket.depth_) | bucket.pattern_;
+}
+
+template <typename K, typename V>
+void PackedHashTable<K, V>::Store(Bucket *bucket, uint32_t slot, uint32_t key) {
+  uint32_t high = bucket->depth_ >= 32 ? 0 : key >> bucket->depth_;
+  uint32_t delta = high - bucket->base_;
+  memcpy(&bucket->packed_[slot * bucket->width_], &delta, bucket->width_);
+}
+
+template <typename K, typename V>
+void PackedHashTable<K, V>::Encode(Bucket *bucket, const std::vector<uint32_t> &keys) const {
+  uint32_t min_high = UINT32_MAX;
+  uint32_t max_high = 0;
+  for (uint32_t key : keys) {
+    uint32_t high = bucket->depth_ >= 32 ? 0 : key >> bucket->depth_;
+    min_high = std::min(min_high, high);
+    max_high = std::max(max_high, high);
+  }
+  bucket->base_ = keys.empty() ? 0 : min_high;
+  uint32_t range = keys.empty() ? 0 : max_high - min_high;
+  bucket->width_ = range <= UINT8_MAX ? 1 : range <= UINT16_MAX ? 2 : 4;
+  bucket->packed_.assign(RoundUp(bucket_size_ * bucket->width_), 0);
+  bucket->size_ = static_cast<uint32_t>(keys.size());
+  for (uint32_t i = 0; i < bucket->size_; i++) {
+    Store(bucket, i, keys[i]);
+  }
+}
+
+template <typename K, typename V>
+void PackedHashTable<K, V>::SplitBucket(size_t dir_index) {
+  std::shared_ptr<Bucket> bucket = dir_[dir_index];
+  int depth = bucket->depth_;
+  if (depth == global_depth_) {
+    size_t dir_len = dir_.size();
+    for (size_t i = 0; i < dir_len; i++) {
+      dir_.push_back(dir_[i]);
+    }
+    global_depth_++;
+  }
+
+  // 按第 depth 位把条目分到两个新桶，各自重新选择基准和位宽
+  auto low = std::make_shared<Bucket>();
+  auto high = std::make_shared<Bucket>();
+  low->depth_ = high->depth_ = depth + 1;
+  low->pattern_ = bucket->pattern_;
+  high->pattern_ = bucket->pattern_ | (1U << depth);
+  std::vector<uint32_t> low_keys;
+  std::vector<uint32_t> high_keys;
+  for (uint32_t i = 0; i < bucket->size_; i++) {
+    uint32_t key = KeyAt(*bucket, i);
+    if (((key >> depth) & 1) != 0) {
+      high_keys.push_back(key);
+      high->values_.push_back(std::move(bucket->values_[i]));
+    } else {
+      low_keys.push_back(key);
+      low->values_.push_back(std::move(bucket->values_[i]));
+    }
+  }
+  Encode(low.get(), low_keys);
+  Encode(high.get(), high_keys);
+
+  uint32_t mask = (1U << depth) - 1;
+  for (size_t i = 0; i < dir_.size(); i++) {
+    if ((i & mask) == bucket->pattern_) {
+      dir_[i] = ((i >> depth) & 1) != 0 ? high : low;
+    }
+  }
+  num_buckets_++;
+}
+
+template class PackedHashTable<int, int>;
+template class PackedHashTable<page_id_t, Page *>;
+
+}  // namespace bustub
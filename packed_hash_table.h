@@ -0,0 +1,150 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// packed_hash_table.h
+//
+// Identification: src/include/container/hash/packed_hash_table.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+/**
+ * packed_hash_table.h
+ *
+ * Implementation of in-memory extendible hash table with compressed buckets for integer keys
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <type_traits>
+#include <vector>
+
+#include "container/hash/hash_table.h"
+
+namespace bustub {
+
+/**
+ * PackedHashTable is an extendible hash table for integer keys (int, page_id_t) that stores the keys of
+ * a bucket bit-packed, for very large read-mostly tables.
+ *
+ * Like ExtendibleHashTable with std::hash on integers, the directory is indexed by the low global_depth
+ * bits of the key, so every key in a bucket of local depth d shares its low d bits. A bucket therefore
+ * only stores `(key >> d) - base` (frame of reference), using 1, 2 or 4 bytes per key depending on the
+ * largest difference; dense page ids typically fit in one byte. A probe compares 16 bytes of packed keys
+ * at a time with SSE2 (scalar fallback elsewhere). Writes that do not fit the current encoding re-encode
+ * the bucket.
+ *
+ * @tparam K integer key type of at most 32 bits
+ * @tparam V value type
+ */
+template <typename K, typename V>
+class PackedHashTable : public HashTable<K, V> {
+  static_assert(std::is_integral_v<K> && sizeof(K) <= sizeof(uint32_t), "packed keys must be integers of <= 32 bits");
+
+ public:
+  /**
+   * @brief Create a new PackedHashTable.
+   * @param bucket_size maximum number of entries per bucket
+   */
+  explicit PackedHashTable(size_t bucket_size = 64);
+
+  /**
+   * @brief Get the global depth of the directory.
+   * @return The global depth of the directory.
+   */
+  auto GetGlobalDepth() const -> int;
+
+  /**
+   * @brief Get the number of buckets in the directory.
+   * @return The number of buckets in the directory.
+   */
+  auto GetNumBuckets() const -> int;
+
+  /**
+   * @brief Get the bytes of directory and bucket storage (packed keys, values) used per stored entry.
+   * @return Bytes per entry, or 0 if the table is empty.
+   */
+  auto GetBytesPerEntry() const -> double;
+
+  /**
+   * @brief Get the average number of 16-byte key blocks compared per Find (keys compared without SSE2).
+   * @return Probe cost, or 0 if nothing was probed yet.
+   */
+  auto GetAverageProbeCost() const -> double;
+
+  /**
+   * @brief Find the value associated with the given key.
+   * @param key The key to be searched.
+   * @param[out] value The value associated with the key.
+   * @return True if the key is found, false otherwise.
+   */
+  auto Find(const K &key, V &value) -> bool override;
+
+  /**
+   * @brief Insert the given key-value pair into the hash table.
+   * If a key already exists, the value should be updated.
+   * @param key The key to be inserted.
+   * @param value The value to be inserted.
+   */
+  void Insert(const K &key, const V &value) override;
+
+  /**
+   * @brief Given the key, remove the corresponding key-value pair in the hash table.
+   * @param key The key to be deleted.
+   * @return True if the key exists, false otherwise.
+   */
+  auto Remove(const K &key) -> bool override;
+
+ private:
+  struct Bucket {
+    int depth_{0};
+    uint32_t pattern_{0};  // the low depth_ bits shared by every key in the bucket
+    uint32_t base_{0};     // frame of reference for key >> depth_
+    uint32_t width_{1};    // bytes per packed key: 1, 2 or 4
+    uint32_t size_{0};     // number of entries
+    std::vector<uint8_t> packed_;  // size_ packed keys, padded to a multiple of 16 bytes for SIMD loads
+    std::vector<V> values_;        // values_[i] belongs to packed key i
+  };
+
+  /*****************************************************************
+   * Must acquire latch_ first before calling the below functions. *
+   *****************************************************************/
+
+  auto IndexOf(uint32_t key) const -> size_t { return key & ((size_t{1} << global_depth_) - 1); }
+
+  /**
+   * @brief Find the slot of a key in a bucket.
+   * @param[out] blocks number of key blocks compared
+   * @return The slot, or -1 if the key is absent.
+   */
+  static auto Locate(const Bucket &bucket, uint32_t key, uint64_t *blocks) -> int;
+
+  /** @brief Decode the key stored at a slot. */
+  static auto KeyAt(const Bucket &bucket, uint32_t slot) -> uint32_t;
+
+  /** @brief Store the packed form of `key` at a slot; the key must fit the bucket's base and width. */
+  static void Store(Bucket *bucket, uint32_t slot, uint32_t key);
+
+  /** @brief Pick base and width for the given keys and pack them; values_ must already be in key order. */
+  void Encode(Bucket *bucket, const std::vector<uint32_t> &keys) const;
+
+  /** @brief Split the bucket the given directory index points to, doubling the directory if needed. */
+  void SplitBucket(size_t dir_index);
+
+  size_t bucket_size_;
+  int global_depth_{0};
+  int num_buckets_{1};
+  size_t size_{0};
+  mutable std::shared_mutex latch_;
+  std::vector<std::shared_ptr<Bucket>> dir_;
+
+  std::atomic<uint64_t> probes_{0};
+  std::atomic<uint64_t> probe_blocks_{0};
+};
+
+}  // namespace bustub
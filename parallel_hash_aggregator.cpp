@@ -0,0 +1,81 @@
+#include "execution/parallel_hash_aggregator.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>  // NOLINT
+#include <unordered_map>
+
+namespace bustub {
+
+template <typename K, typename V>
+ParallelHashAggregator<K, V>::ParallelHashAggregator(size_t num_threads, size_t num_partitions, CombineFn combine,
+                                                     size_t bucket_size)
+    : num_threads_(std::max<size_t>(1, num_threads)), combine_(std::move(combine)) {
+  BUSTUB_ASSERT(num_partitions > 0, "at least one partition is required");
+  for (size_t i = 0; i < num_partitions; i++) {
+    partitions_.emplace_back(std::make_unique<ExtendibleHashTable<K, V>>(bucket_size));
+  }
+}
+
+template <typename K, typename V>
+auto ParallelHashAggregator<K, V>::PartitionOf(const K &key) const -> size_t {
+  // Use the high bits of a multiplicative hash: ExtendibleHashTable indexes with the low bits of
+  // std::hash, so partitioning on them would leave each partition's directory with constant low bits
+  uint64_t h = static_cast<uint64_t>(std::hash<K>()(key)) * 0x9E3779B97F4A7C15ULL;
+  return (h >> 32) % partitions_.size();
+}
+
+template <typename K, typename V>
+void ParallelHashAggregator<K, V>::Aggregate(const std::vector<std::pair<K, V>> &rows) {
+  size_t num_partitions = partitions_.size();
+  // local[worker][partition]: pre-aggregates private to one worker
+  std::vector<std::vector<std::unordered_map<K, V>>> local(num_threads_,
+                                                           std::vector<std::unordered_map<K, V>>(num_partitions));
+
+  // 1. 线程本地预聚合：每个线程处理输入的一段，不加锁
+  std::vector<std::thread> workers;
+  size_t chunk = (rows.size() + num_threads_ - 1) / num_threads_;
+  for (size_t w = 0; w < num_threads_; w++) {
+    workers.emplace_back([&, w] {
+      size_t begin = std::min(rows.size(), w * chunk);
+      size_t end = std::min(rows.size(), begin + chunk);
+      for (size_t i = begin; i < end; i++) {
+        auto &map = local[w][PartitionOf(rows[i].first)];
+        auto [it, inserted] = map.try_emplace(rows[i].first, rows[i].second);
+        if (!inserted) {
+          combine_(it->second, rows[i].second);
+        }
+      }
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  workers.clear();
+
+  // 2. 按分区合并：每个分区只由一个线程写入，互不竞争
+  for (size_t w = 0; w < num_threads_; w++) {
+    workers.emplace_back([&, w] {
+      std::vector<std::pair<K, V>> batch;
+      for (size_t p = w; p < num_partitions; p += num_threads_) {
+        for (size_t source = 0; source < num_threads_; source++) {
+          auto &map = local[source][p];
+          batch.assign(map.begin(), map.end());
+          partitions_[p]->UpsertBatch(batch, combine_);
+        }
+      }
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+}
+
+template <typename K, typename V>
+auto ParallelHashAggregator<K, V>::Find(const K &key, V &value) -> bool {
+  return partitions_[PartitionOf(key)]->Find(key, value);
+}
+
+template class ParallelHashAggregator<int, int>;
+
+}  // namespace bustub
@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_hash_aggregator.h
+//
+// Identification: src/include/execution/parallel_hash_aggregator.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+#include "container/hash/extendible_hash_table.h"
+
+namespace bustub {
+
+/**
+ * ParallelHashAggregator computes a grouped aggregation (GROUP BY key, combine(values)) with several threads.
+ *
+ * Aggregate() runs in two phases:
+ *   1. Every worker pre-aggregates its own slice of the input into private per-partition maps, so the
+ *      hot loop touches no shared state and no latch.
+ *   2. Every partition is owned by exactly one worker, which folds all workers' pre-aggregates for that
+ *      partition into the partition's ExtendibleHashTable with one UpsertBatch per source.
+ *
+ * Each key lives in exactly one partition, so the final tables never contend with each other.
+ *
+ * @tparam K group key type
+ * @tparam V aggregate value type
+ */
+template <typename K, typename V>
+class ParallelHashAggregator {
+ public:
+  using CombineFn = std::function<void(V &, const V &)>;
+
+  /**
+   * @param num_threads number of worker threads used by Aggregate
+   * @param num_partitions number of result partitions, ideally a small multiple of num_threads
+   * @param combine folds a row value into an existing aggregate: combine(aggregate, value)
+   * @param bucket_size bucket size of the per-partition ExtendibleHashTables
+   */
+  ParallelHashAggregator(size_t num_threads, size_t num_partitions, CombineFn combine, size_t bucket_size = 64);
+
+  DISALLOW_COPY_AND_MOVE(ParallelHashAggregator);
+
+  /**
+   * @brief Aggregate a chunk of rows into the result. May be called repeatedly with further chunks.
+   * @param rows (group key, value) pairs
+   */
+  void Aggregate(const std::vector<std::pair<K, V>> &rows);
+
+  /**
+   * @brief Look up the aggregate of one group.
+   * @param key The group key.
+   * @param[out] value The aggregate of the group.
+   * @return True if the group exists, false otherwise.
+   */
+  auto Find(const K &key, V &value) -> bool;
+
+  /** @brief Get the number of result partitions. */
+  auto GetNumPartitions() const -> size_t { return partitions_.size(); }
+
+  /** @brief Get one result partition. */
+  auto GetPartition(size_t index) -> ExtendibleHashTable<K, V> & { return *partitions_[index]; }
+
+ private:
+  auto PartitionOf(const K &key) const -> size_t;
+
+  size_t num_threads_;
+  CombineFn combine_;
+  std::vector<std::unique_ptr<ExtendibleHashTable<K, V>>> partitions_;
+};
+
+}  // namespace bustub
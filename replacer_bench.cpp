@@ -0,0 +1,758 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// replacer_bench.cpp
+//
+// Identification: tools/replacer_bench/replacer_bench.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+// Trace-driven measurements of the page replacers: hit ratios on synthetic traces, and the cost per access.
+// The tree has no buffer pool simulator, so this drives each replacer the way a buffer pool would: a page
+// table maps pages to frames, a miss takes a free frame or asks the replacer for a victim, and every frame
+// is evictable while it is not being accessed. Every trace comes from a fixed seed, so two runs print the
+// same hit ratios; timings depend on the machine and should be taken with an optimized build.
+//
+// Usage: replacer_bench [epoch|slru|s3fifo|lrfu|shadow|refault|hints|skiplist|all]
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>  // NOLINT
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/lrfu_replacer.h"
+#include "buffer/lru_k_replacer.h"
+#include "buffer/s3fifo_replacer.h"
+#include "buffer/shadow_policy_evaluator.h"
+#include "buffer/skiplist_lru_k_replacer.h"
+#include "buffer/slru_replacer.h"
+
+namespace bustub {
+namespace {
+
+using Trace = std::vector<page_id_t>;
+
+/**
+ * Zipf-distributed accesses (exponent 0.9) over `pages` pages, interrupted about once every 1000 accesses by
+ * a sequential scan of `scan_length` pages that are never accessed again. A scan that starts before `length`
+ * accesses runs to its end, so the trace can be slightly longer.
+ */
+auto ZipfScanTrace(size_t length, int pages, int scan_length, unsigned seed) -> Trace {
+  std::mt19937 rng(seed);
+  std::vector<double> cdf(pages);
+  double sum = 0;
+  for (int i = 0; i < pages; i++) {
+    sum += 1.0 / std::pow(i + 1, 0.9);
+    cdf[i] = sum;
+  }
+  std::uniform_real_distribution<double> uniform(0, sum);
+  Trace trace;
+  page_id_t scan_page = pages;
+  while (trace.size() < length) {
+    if (rng() % 1000 == 0) {
+      for (int i = 0; i < scan_length; i++) {
+        trace.push_back(scan_page++);
+      }
+      continue;
+    }
+    trace.push_back(std::lower_bound(cdf.begin(), cdf.end(), uniform(rng)) - cdf.begin());
+  }
+  return trace;
+}
+
+/** Every access repeated once, with neighbouring accesses swapped at random: correlated reference pairs. */
+auto PairedTrace(const Trace &base, unsigned seed) -> Trace {
+  std::mt19937 rng(seed);
+  Trace trace;
+  for (page_id_t page : base) {
+    trace.push_back(page);
+    trace.push_back(page);
+  }
+  for (size_t i = 1; i < trace.size(); i++) {
+    if (rng() % 2 != 0) {
+      std::swap(trace[i], trace[i - 1]);
+    }
+  }
+  return trace;
+}
+
+auto UniformTrace(size_t length, int pages, unsigned seed) -> Trace {
+  std::mt19937 rng(seed);
+  Trace trace(length);
+  for (auto &page : trace) {
+    page = rng() % pages;
+  }
+  return trace;
+}
+
+/** The ranks of the zipf pages rotate by 5000 every 50k accesses; scan pages are left alone. */
+auto ShiftingTrace(const Trace &base, int pages) -> Trace {
+  Trace trace(base.size());
+  for (size_t i = 0; i < base.size(); i++) {
+    trace[i] = base[i] < pages ? (base[i] + 5000 * static_cast<int>(i / 50000)) % pages : base[i];
+  }
+  return trace;
+}
+
+auto LoopTrace(size_t length, int loop_pages) -> Trace {
+  Trace trace;
+  while (trace.size() < length) {
+    for (int i = 0; i < loop_pages; i++) {
+      trace.push_back(i);
+    }
+  }
+  return trace;
+}
+
+auto ElapsedMicros(std::chrono::steady_clock::time_point start) -> double {
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Replay a trace against a replacer with num_frames frames and return the hit ratio. Replacers that take a page
+ * id on RecordAccess get it. If us_per_access is not null, it receives the wall time per access.
+ */
+template <typename Replacer>
+auto Simulate(Replacer *replacer, const Trace &trace, size_t num_frames, double *us_per_access = nullptr) -> double {
+  std::unordered_map<page_id_t, frame_id_t> page_table;
+  std::vector<page_id_t> frame_pages(num_frames, INVALID_PAGE_ID);
+  size_t used = 0;
+  size_t hits = 0;
+  auto record = [&](frame_id_t frame_id, page_id_t page_id) {
+    if constexpr (std::is_same_v<Replacer, LRUKReplacer> || std::is_same_v<Replacer, S3FIFOReplacer>) {
+      replacer->RecordAccess(frame_id, page_id);
+    } else {
+      replacer->RecordAccess(frame_id);
+    }
+  };
+  auto start = std::chrono::steady_clock::now();
+  for (page_id_t page_id : trace) {
+    auto it = page_table.find(page_id);
+    if (it != page_table.end()) {
+      hits++;
+      record(it->second, page_id);
+      continue;
+    }
+    frame_id_t frame_id;
+    if (used < num_frames) {
+      frame_id = static_cast<frame_id_t>(used++);
+    } else {
+      if (!replacer->Evict(&frame_id)) {
+        std::fprintf(stderr, "replacer found no victim with every frame evictable\n");
+        std::exit(1);
+      }
+      page_table.erase(frame_pages[frame_id]);
+    }
+    frame_pages[frame_id] = page_id;
+    page_table[page_id] = frame_id;
+    record(frame_id, page_id);
+    replacer->SetEvictable(frame_id, true);
+  }
+  if (us_per_access != nullptr) {
+    *us_per_access = ElapsedMicros(start) / trace.size();
+  }
+  return static_cast<double>(hits) / trace.size();
+}
+
+/**
+ * Textbook LRU-K used as the reference for the epoch mode: frames with fewer than k accesses are evicted first,
+ * oldest first access first; the others by the oldest k-th most recent access. O(log n) per access.
+ */
+class ReferenceLRUK {
+ public:
+  ReferenceLRUK(size_t num_frames, size_t k) : k_(k), history_(num_frames), first_access_(num_frames) {}
+
+  void Access(frame_id_t frame_id, bool loaded) {
+    if (loaded) {
+      history_[frame_id].clear();
+      first_access_[frame_id] = now_;
+    } else {
+      order_.erase(Key(frame_id));
+    }
+    history_[frame_id].push_back(now_++);
+    if (history_[frame_id].size() > k_) {
+      history_[frame_id].pop_front();
+    }
+    order_.insert(Key(frame_id));
+  }
+
+  auto Evict() -> frame_id_t {
+    frame_id_t victim = std::get<2>(*order_.begin());
+    order_.erase(order_.begin());
+    return victim;
+  }
+
+ private:
+  using OrderKey = std::tuple<bool, size_t, frame_id_t>;
+
+  auto Key(frame_id_t frame_id) const -> OrderKey {
+    const auto &history = history_[frame_id];
+    if (history.size() < k_) {
+      return {false, first_access_[frame_id], frame_id};
+    }
+    return {true, history.front(), frame_id};
+  }
+
+  size_t k_;
+  size_t now_{0};
+  std::vector<std::deque<size_t>> history_;
+  std::vector<size_t> first_access_;
+  std::set<OrderKey> order_;
+};
+
+auto SimulateReference(const Trace &trace, size_t num_frames, size_t k) -> double {
+  ReferenceLRUK reference(num_frames, k);
+  std::unordered_map<page_id_t, frame_id_t> page_table;
+  std::vector<page_id_t> frame_pages(num_frames, INVALID_PAGE_ID);
+  size_t used = 0;
+  size_t hits = 0;
+  for (page_id_t page_id : trace) {
+    auto it = page_table.find(page_id);
+    if (it != page_table.end()) {
+      hits++;
+      reference.Access(it->second, false);
+      continue;
+    }
+    frame_id_t frame_id = used < num_frames ? static_cast<frame_id_t>(used++) : reference.Evict();
+    page_table.erase(frame_pages[frame_id]);
+    frame_pages[frame_id] = page_id;
+    page_table[page_id] = frame_id;
+    reference.Access(frame_id, true);
+  }
+  return static_cast<double>(hits) / trace.size();
+}
+
+/** Hit-path throughput: threads re-access frames that are all resident, in M accesses per second. */
+template <typename Replacer>
+auto HitThroughput(Replacer *replacer, size_t num_frames, int num_threads) -> double {
+  const int accesses_per_thread = 200000;
+  for (size_t i = 0; i < num_frames; i++) {
+    replacer->RecordAccess(static_cast<frame_id_t>(i));
+  }
+  std::vector<std::thread> threads;
+  auto start = std::chrono::steady_clock::now();
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([replacer, num_frames, t] {
+      for (int i = 0; i < accesses_per_thread; i++) {
+        replacer->RecordAccess(static_cast<frame_id_t>((i * 31 + t) % num_frames));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  return static_cast<double>(num_threads) * accesses_per_thread / ElapsedMicros(start);
+}
+
+/**
+ * Throughput with misses, in M operations per second: each access pins and unpins a frame, and one access in
+ * `miss_every` instead evicts a victim and loads it, as a buffer pool does on a miss. Every frame starts
+ * resident and evictable.
+ */
+template <typename Replacer>
+auto EvictMixThroughput(Replacer *replacer, size_t num_frames, int num_threads, int miss_every) -> double {
+  const int accesses_per_thread = 100000;
+  for (size_t i = 0; i < num_frames; i++) {
+    replacer->RecordAccess(static_cast<frame_id_t>(i));
+    replacer->SetEvictable(static_cast<frame_id_t>(i), true);
+  }
+  std::vector<std::thread> threads;
+  auto start = std::chrono::steady_clock::now();
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([replacer, num_frames, miss_every, t] {
+      for (int i = 0; i < accesses_per_thread; i++) {
+        auto frame_id = static_cast<frame_id_t>((i * 31 + t) % num_frames);
+        if (i % miss_every == 0) {
+          // Another thread may have taken every victim; the access just counts as a hit then
+          if (!replacer->Evict(&frame_id)) {
+            continue;
+          }
+        } else {
+          replacer->SetEvictable(frame_id, false);
+        }
+        replacer->RecordAccess(frame_id);
+        replacer->SetEvictable(frame_id, true);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  return static_cast<double>(num_threads) * accesses_per_thread / ElapsedMicros(start);
+}
+
+const size_t FRAME_COUNTS[] = {256, 1024, 2048};
+
+// Epoch-bucketed LRU-K against an exact LRU-K
+void RunEpoch() {
+  Trace zipf = ZipfScanTrace(400000, 20000, 300, 7);
+  std::vector<std::pair<const char *, Trace>> traces = {
+      {"zipf+scans", zipf}, {"paired", PairedTrace(zipf, 1)}, {"uniform", UniformTrace(400000, 3000, 3)}};
+  std::printf("epoch mode: hit ratio minus exact LRU-K, by epoch width\n");
+  std::printf("%-11s %2s %6s %7s", "trace", "k", "frames", "exact");
+  const size_t widths[] = {1, 16, 64, 256, 1024, 4096, 16384};
+  for (size_t width : widths) {
+    std::printf(" %7zu", width);
+  }
+  std::printf("\n");
+  for (size_t k : {2, 3}) {
+    for (const auto &[name, trace] : traces) {
+      for (size_t frames : FRAME_COUNTS) {
+        double exact = SimulateReference(trace, frames, k);
+        std::printf("%-11s %2zu %6zu %7.3f", name, k, frames, exact);
+        for (size_t width : widths) {
+          LRUKReplacer replacer(frames, k, width);
+          std::printf(" %+7.3f", Simulate(&replacer, trace, frames) - exact);
+        }
+        std::printf("\n");
+      }
+    }
+  }
+  double scan_us;
+  double epoch_us;
+  LRUKReplacer scan(2048, 2);
+  LRUKReplacer epoch(2048, 2, 64);
+  Simulate(&scan, zipf, 2048, &scan_us);
+  Simulate(&epoch, zipf, 2048, &epoch_us);
+  std::printf("cost at 2048 frames, k = 2: exact scan %.2f us/access, epoch width 64 %.2f us/access\n\n", scan_us,
+              epoch_us);
+}
+
+// Segmented LRU by protected segment size
+void RunSLRU() {
+  Trace trace = ZipfScanTrace(400000, 20000, 300, 7);
+  std::printf("SLRU on zipf+scans: hit ratio (us/access)\n");
+  std::printf("%6s %15s %15s %15s %15s\n", "frames", "LRU-2", "SLRU 50%", "SLRU 80%", "SLRU 95%");
+  for (size_t frames : FRAME_COUNTS) {
+    double us;
+    LRUKReplacer lru_k(frames, 2, 64);
+    double hit_ratio = Simulate(&lru_k, trace, frames, &us);
+    std::printf("%6zu %7.3f (%.2f)", frames, hit_ratio, us);
+    for (double share : {0.5, 0.8, 0.95}) {
+      SLRUReplacer slru(frames, static_cast<size_t>(frames * share));
+      hit_ratio = Simulate(&slru, trace, frames, &us);
+      std::printf(" %7.3f (%.2f)", hit_ratio, us);
+    }
+    std::printf("\n");
+  }
+  std::printf("\n");
+}
+
+// S3-FIFO hit ratios and hit-path throughput
+void RunS3FIFO() {
+  std::vector<std::pair<const char *, Trace>> traces = {{"zipf+scans", ZipfScanTrace(400000, 20000, 300, 7)},
+                                                        {"loop 1200", LoopTrace(400000, 1200)}};
+  std::printf("S3-FIFO: hit ratio\n");
+  std::printf("%-11s %6s %7s %7s %7s\n", "trace", "frames", "LRU-2", "SLRU80", "S3-FIFO");
+  for (const auto &[name, trace] : traces) {
+    for (size_t frames : FRAME_COUNTS) {
+      LRUKReplacer lru_k(frames, 2, 64);
+      SLRUReplacer slru(frames, frames * 8 / 10);
+      S3FIFOReplacer s3fifo(frames);
+      std::printf("%-11s %6zu %7.3f %7.3f %7.3f\n", name, frames, Simulate(&lru_k, trace, frames),
+                  Simulate(&slru, trace, frames), Simulate(&s3fifo, trace, frames));
+    }
+  }
+  std::printf("hit path on 1024 resident frames, M accesses/s (hardware threads: %u)\n",
+              std::thread::hardware_concurrency());
+  std::printf("%7s %7s %7s %7s\n", "threads", "LRU-2", "SLRU80", "S3-FIFO");
+  for (int threads : {1, 64}) {
+    LRUKReplacer lru_k(1024, 2, 64);
+    SLRUReplacer slru(1024, 800);
+    S3FIFOReplacer s3fifo(1024);
+    std::printf("%7d %7.1f %7.1f %7.1f\n", threads, HitThroughput(&lru_k, 1024, threads),
+                HitThroughput(&slru, 1024, threads), HitThroughput(&s3fifo, 1024, threads));
+  }
+  std::printf("\n");
+}
+
+// LRFU lambda sweep
+void RunLRFU() {
+  const int pages = 20000;
+  Trace zipf = ZipfScanTrace(400000, pages, 300, 7);
+  std::vector<std::pair<const char *, Trace>> traces = {{"zipf+scans", zipf}, {"shifting", ShiftingTrace(zipf, pages)}};
+  const double lambdas[] = {0, 1e-5, 1e-4, 1e-3, 1e-2, 1e-1, 1};
+  std::printf("LRFU: hit ratio by lambda\n");
+  std::printf("%-11s %6s %7s", "trace", "frames", "LRU-2");
+  for (double lambda : lambdas) {
+    std::printf(" %7g", lambda);
+  }
+  std::printf("\n");
+  for (const auto &[name, trace] : traces) {
+    for (size_t frames : {256, 1024}) {
+      LRUKReplacer lru_k(frames, 2, 64);
+      std::printf("%-11s %6zu %7.3f", name, frames, Simulate(&lru_k, trace, frames));
+      for (double lambda : lambdas) {
+        LRFUReplacer lrfu(frames, lambda);
+        std::printf(" %7.3f", Simulate(&lrfu, trace, frames));
+      }
+      std::printf("\n");
+    }
+  }
+  std::printf("\n");
+}
+
+// Shadow policies on sampled traffic against full-size simulations
+void RunShadow() {
+  const size_t frames = 8192;
+  Trace trace = ZipfScanTrace(2000000, 200000, 2000, 7);
+  double plain_us;
+  LRUKReplacer plain(frames, 2, 64);
+  double live = Simulate(&plain, trace, frames, &plain_us);
+
+  ShadowPolicyEvaluator full(frames, 0);
+  full.AddLRUKPolicy(2);
+  full.AddLRUKPolicy(3);
+  full.AddARCPolicy();
+  for (page_id_t page_id : trace) {
+    full.RecordAccess(page_id, false);
+  }
+  auto full_stats = full.GetStats();
+
+  std::printf("shadow evaluation, %zu frames, live policy epoch LRU-2 (full-size live hit ratio %.4f)\n", frames, live);
+  std::printf("%-10s %7s %7s %7s %7s %10s %10s\n", "sample", "live", "LRU-2", "LRU-3", "ARC", "dropped", "us/access");
+  std::printf("%-10s %7.4f %7.4f %7.4f %7.4f %10s %10.2f\n", "full size", live, full_stats.GetHitRate(0),
+              full_stats.GetHitRate(1), full_stats.GetHitRate(2), "-", plain_us);
+  for (uint32_t shift : {4, 6}) {
+    ShadowPolicyEvaluator evaluator(frames, shift);
+    evaluator.AddLRUKPolicy(2);
+    evaluator.AddLRUKPolicy(3);
+    evaluator.AddARCPolicy();
+    LRUKReplacer replacer(frames, 2, 64);
+    replacer.AttachShadowEvaluator(&evaluator);
+    double us;
+    Simulate(&replacer, trace, frames, &us);
+    auto stats = evaluator.GetStats();
+    std::string sample = "1/" + std::to_string(1U << shift);
+    std::printf("%-10s %7.4f %7.4f %7.4f %7.4f %10lu %10.2f\n", sample.c_str(), stats.GetLiveHitRate(),
+                stats.GetHitRate(0), stats.GetHitRate(1), stats.GetHitRate(2),
+                static_cast<unsigned long>(stats.dropped_accesses_), us);  // NOLINT
+  }
+  std::printf("\n");
+}
+
+auto SimulateRefault(const Trace &trace, size_t frames, size_t epoch_width, bool refault) -> double {
+  LRUKReplacer replacer(frames, 2, epoch_width);
+  replacer.EnableRefaultDetection(refault);
+  return Simulate(&replacer, trace, frames);
+}
+
+// Refault-distance activation on loops and on a zipf/loop mix
+void RunRefault() {
+  const size_t frames = 1000;
+  std::printf("refault detection, %zu frames, k = 2: hit ratio\n", frames);
+  std::printf("%-12s %8s %8s %8s %8s\n", "trace", "exact", "+refault", "epoch", "+refault");
+  auto print_row = [&](const std::string &name, const Trace &trace) {
+    std::printf("%-12s %8.3f %8.3f %8.3f %8.3f\n", name.c_str(), SimulateRefault(trace, frames, 0, false),
+                SimulateRefault(trace, frames, 0, true), SimulateRefault(trace, frames, 64, false),
+                SimulateRefault(trace, frames, 64, true));
+  };
+  for (double ratio : {1.1, 1.25, 1.5, 1.9, 2.5}) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "loop %.2fx", ratio);
+    print_row(name, LoopTrace(300000, static_cast<int>(frames * ratio)));
+  }
+  // Half the accesses go to 300 hot pages, half walk a loop of 1200 pages
+  std::mt19937 rng(3);
+  Trace mix;
+  while (mix.size() < 300000) {
+    if (rng() % 2 != 0) {
+      mix.push_back(rng() % 300);
+    } else {
+      mix.push_back(1000 + (mix.size() / 2) % 1200);
+    }
+  }
+  print_row("zipf/loop", mix);
+  std::printf("\n");
+}
+
+/** An access of the hints experiment; loop and scan say which hint an executor would give for the page. */
+struct HintedAccess {
+  page_id_t page_id_;
+  bool loop_;
+  bool scan_;
+};
+
+auto SimulateHints(const std::vector<HintedAccess> &trace, size_t frames, size_t epoch_width, bool hints) -> double {
+  LRUKReplacer replacer(frames, 2, epoch_width);
+  std::unordered_map<page_id_t, frame_id_t> page_table;
+  std::vector<page_id_t> frame_pages(frames, INVALID_PAGE_ID);
+  size_t used = 0;
+  size_t hits = 0;
+  size_t group = LRUKReplacer::NEW_LOOP_GROUP;
+  for (const auto &access : trace) {
+    frame_id_t frame_id;
+    auto it = page_table.find(access.page_id_);
+    if (it != page_table.end()) {
+      hits++;
+      frame_id = it->second;
+      replacer.SetEvictable(frame_id, false);
+    } else {
+      if (used < frames) {
+        frame_id = static_cast<frame_id_t>(used++);
+      } else if (replacer.Evict(&frame_id)) {
+        page_table.erase(frame_pages[frame_id]);
+      } else {
+        std::fprintf(stderr, "replacer found no victim with every frame evictable\n");
+        std::exit(1);
+      }
+      frame_pages[frame_id] = access.page_id_;
+      page_table[access.page_id_] = frame_id;
+    }
+    replacer.RecordAccess(frame_id, access.page_id_);
+    if (hints && access.loop_) {
+      group = replacer.HintLoop({frame_id}, group);
+    }
+    replacer.SetEvictable(frame_id, true);
+    if (hints && access.scan_) {
+      replacer.HintDone(frame_id);
+    }
+  }
+  return static_cast<double>(hits) / trace.size();
+}
+
+// Done and loop hints
+void RunHints() {
+  const size_t frames = 1000;
+  std::printf("executor hints, %zu frames, k = 2: hit ratio\n", frames);
+  std::printf("%-12s %7s %7s %7s %7s\n", "trace", "exact", "+hints", "epoch", "+hints");
+  auto print_row = [&](const std::string &name, const std::vector<HintedAccess> &trace) {
+    std::printf("%-12s %7.3f %7.3f %7.3f %7.3f\n", name.c_str(), SimulateHints(trace, frames, 0, false),
+                SimulateHints(trace, frames, 0, true), SimulateHints(trace, frames, 64, false),
+                SimulateHints(trace, frames, 64, true));
+  };
+  for (double ratio : {1.1, 1.25, 1.5, 1.9, 2.5}) {
+    std::vector<HintedAccess> trace;
+    for (page_id_t page_id : LoopTrace(300000, static_cast<int>(frames * ratio))) {
+      trace.push_back({page_id, true, false});
+    }
+    char name[32];
+    std::snprintf(name, sizeof(name), "loop %.2fx", ratio);
+    print_row(name, trace);
+  }
+  {
+    // 800 hot pages mixed 1:1 with a one-pass scan
+    std::mt19937 rng(7);
+    std::vector<HintedAccess> trace;
+    page_id_t scan_page = 100000;
+    while (trace.size() < 300000) {
+      if (rng() % 2 != 0) {
+        trace.push_back({static_cast<page_id_t>(rng() % 800), false, false});
+      } else {
+        trace.push_back({scan_page++, false, true});
+      }
+    }
+    print_row("hot+scan", trace);
+  }
+  {
+    // 300 hot pages mixed 1:1 with a loop of 1500 pages
+    std::mt19937 rng(9);
+    std::vector<HintedAccess> trace;
+    int position = 0;
+    while (trace.size() < 300000) {
+      if (rng() % 2 != 0) {
+        trace.push_back({static_cast<page_id_t>(rng() % 300), false, false});
+      } else {
+        trace.push_back({10000 + position++ % 1500, true, false});
+      }
+    }
+    print_row("hot+loop", trace);
+  }
+  std::printf("\n");
+}
+
+/**
+ * Exact LRU-K over a fixed set of frames, with evictable flags, for checking a replacer operation by operation:
+ * frames with fewer than k accesses go first by their first access, the others by their k-th most recent
+ * access. Evict scans every frame.
+ */
+class LRUKModel {
+ public:
+  LRUKModel(size_t num_frames, size_t k) : k_(k), frames_(num_frames) {}
+
+  void RecordAccess(frame_id_t frame_id) {
+    auto &history = frames_[frame_id].history_;
+    history.push_back(now_++);
+    if (history.size() > k_) {
+      history.pop_front();
+    }
+  }
+
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) {
+    if (!frames_[frame_id].history_.empty()) {
+      frames_[frame_id].evictable_ = set_evictable;
+    }
+  }
+
+  void Remove(frame_id_t frame_id) {
+    if (frames_[frame_id].evictable_) {
+      frames_[frame_id] = Frame{};
+    }
+  }
+
+  auto Evict(frame_id_t *frame_id) -> bool {
+    bool found = false;
+    std::pair<bool, size_t> best;
+    for (size_t i = 0; i < frames_.size(); i++) {
+      if (!frames_[i].evictable_) {
+        continue;
+      }
+      // Until k accesses the front of the history is the first access, afterwards the k-th most recent one
+      std::pair<bool, size_t> key{frames_[i].history_.size() == k_, frames_[i].history_.front()};
+      if (!found || key < best) {
+        best = key;
+        *frame_id = static_cast<frame_id_t>(i);
+        found = true;
+      }
+    }
+    if (found) {
+      frames_[*frame_id] = Frame{};
+    }
+    return found;
+  }
+
+  auto Size() const -> size_t {
+    return std::count_if(frames_.begin(), frames_.end(), [](const Frame &frame) { return frame.evictable_; });
+  }
+
+ private:
+  struct Frame {
+    std::deque<size_t> history_;  // the last k access timestamps
+    bool evictable_{false};
+  };
+
+  size_t k_;
+  size_t now_{0};
+  std::vector<Frame> frames_;
+};
+
+/** Replay random operations against a replacer and the model; return the number of operations that differ. */
+template <typename Replacer>
+auto CheckAgainstModel(Replacer *replacer, size_t num_frames, size_t k, int operations, unsigned seed) -> int {
+  LRUKModel model(num_frames, k);
+  std::mt19937 rng(seed);
+  int mismatches = 0;
+  for (int i = 0; i < operations; i++) {
+    auto frame_id = static_cast<frame_id_t>(rng() % num_frames);
+    switch (rng() % 8) {
+      case 0:
+      case 1:
+      case 2:
+        replacer->RecordAccess(frame_id);
+        model.RecordAccess(frame_id);
+        break;
+      case 3:
+        replacer->SetEvictable(frame_id, true);
+        model.SetEvictable(frame_id, true);
+        break;
+      case 4:
+        replacer->SetEvictable(frame_id, false);
+        model.SetEvictable(frame_id, false);
+        break;
+      case 5:
+        replacer->Remove(frame_id);
+        model.Remove(frame_id);
+        break;
+      default: {
+        frame_id_t victim = -1;
+        frame_id_t expected = -1;
+        bool evicted = replacer->Evict(&victim);
+        bool expected_evicted = model.Evict(&expected);
+        mismatches += evicted != expected_evicted || victim != expected ? 1 : 0;
+      }
+    }
+    mismatches += replacer->Size() != model.Size() ? 1 : 0;
+  }
+  return mismatches;
+}
+
+// Lock-free skiplist LRU-K against the latched replacer, exact and epoch mode
+void RunSkipList() {
+  const int rounds = 20;
+  const int operations = 20000;
+  int mismatches = 0;
+  for (int round = 0; round < rounds; round++) {
+    size_t k = 2 + round % 2;
+    SkipListLRUKReplacer replacer(64, k);
+    mismatches += CheckAgainstModel(&replacer, 64, k, operations, round);
+  }
+  std::printf("skiplist LRU-K: %d x %d random operations against an exact LRU-K model, %d mismatches\n", rounds,
+              operations, mismatches);
+  if (mismatches != 0) {
+    std::exit(1);
+  }
+
+  Trace trace = ZipfScanTrace(400000, 20000, 300, 7);
+  std::printf("zipf+scans, k = 2: hit ratio\n");
+  std::printf("%6s %7s %7s %7s\n", "frames", "ref", "epoch", "skip");
+  for (size_t frames : FRAME_COUNTS) {
+    LRUKReplacer epoch(frames, 2, 64);
+    SkipListLRUKReplacer skiplist(frames, 2);
+    double epoch_ratio = Simulate(&epoch, trace, frames);
+    std::printf("%6zu %7.3f %7.3f %7.3f\n", frames, SimulateReference(trace, frames, 2), epoch_ratio,
+                Simulate(&skiplist, trace, frames));
+  }
+
+  std::printf("1024 frames, M operations/s (hardware threads: %u)\n", std::thread::hardware_concurrency());
+  std::printf("%-16s %7s %7s %7s %7s\n", "workload", "threads", "exact", "epoch", "skip");
+  for (int threads : {1, 8, 64}) {
+    LRUKReplacer exact(1024, 2);
+    LRUKReplacer epoch(1024, 2, 64);
+    SkipListLRUKReplacer skiplist(1024, 2);
+    double exact_rate = HitThroughput(&exact, 1024, threads);
+    double epoch_rate = HitThroughput(&epoch, 1024, threads);
+    std::printf("%-16s %7d %7.2f %7.2f %7.2f\n", "hits", threads, exact_rate, epoch_rate,
+                HitThroughput(&skiplist, 1024, threads));
+  }
+  for (int threads : {1, 8, 64}) {
+    LRUKReplacer exact(1024, 2);
+    LRUKReplacer epoch(1024, 2, 64);
+    SkipListLRUKReplacer skiplist(1024, 2);
+    double exact_rate = EvictMixThroughput(&exact, 1024, threads, 16);
+    double epoch_rate = EvictMixThroughput(&epoch, 1024, threads, 16);
+    std::printf("%-16s %7d %7.2f %7.2f %7.2f\n", "1/16 evictions", threads, exact_rate, epoch_rate,
+                EvictMixThroughput(&skiplist, 1024, threads, 16));
+  }
+  std::printf("\n");
+}
+
+}  // namespace
+}  // namespace bustub
+
+auto main(int argc, char **argv) -> int {
+  struct Experiment {
+    const char *name_;
+    void (*run_)();
+  };
+  const Experiment experiments[] = {{"epoch", bustub::RunEpoch},     {"slru", bustub::RunSLRU},
+                                    {"s3fifo", bustub::RunS3FIFO},   {"lrfu", bustub::RunLRFU},
+                                    {"shadow", bustub::RunShadow},   {"refault", bustub::RunRefault},
+                                    {"hints", bustub::RunHints},     {"skiplist", bustub::RunSkipList}};
+  const char *which = argc > 1 ? argv[1] : "all";
+  bool found = false;
+  for (const auto &experiment : experiments) {
+    if (std::strcmp(which, "all") == 0 || std::strcmp(which, experiment.name_) == 0) {
+      experiment.run_();
+      found = true;
+    }
+  }
+  if (!found) {
+    std::fprintf(stderr, "usage: %s [epoch|slru|s3fifo|lrfu|shadow|refault|hints|skiplist|all]\n", argv[0]);
+    return 1;
+  }
+  return 0;
+}
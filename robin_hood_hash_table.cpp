@@ -0,0 +1,142 @@
+#include <algorithm>
+#include <functional>
+#include <list>
+#include <string>
+#include <utility>
+
+#include "common/macros.h"
+#include "container/hash/robin_hood_hash_table.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+template <typename K, typename V>
+RobinHoodHashTable<K, V>::RobinHoodHashTable(size_t initial_capacity, double max_load_factor)
+    : max_load_factor_(max_load_factor) {
+  BUSTUB_ASSERT(max_load_factor_ > 0 && max_load_factor_ < 1, "max_load_factor must be in (0, 1)");
+  size_t capacity = 8;
+  while (capacity < initial_capacity) {
+    capacity <<= 1;
+  }
+  slots_.resize(capacity);
+}
+
+template <typename K, typename V>
+auto RobinHoodHashTable<K, V>::GetCapacity() const -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return slots_.size();
+}
+
+template <typename K, typename V>
+auto RobinHoodHashTable<K, V>::GetMaxProbeDistance() const -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  size_t max_distance = 0;
+  for (const auto &slot : slots_) {
+    if (slot.distance_ != EMPTY) {
+      max_distance = std::max<size_t>(max_distance, slot.distance_);
+    }
+  }
+  return max_distance;
+}
+
+template <typename K, typename V>
+auto RobinHoodHashTable<K, V>::Locate(const K &key) const -> int64_t {
+  size_t index = HashKey(key) & Mask();
+  for (uint32_t distance = 0;; distance++, index = (index + 1) & Mask()) {
+    const Slot &slot = slots_[index];
+    // 空槽或遇到比当前探测距离更“富”的元素，说明键不存在，可以提前结束
+    if (slot.distance_ == EMPTY || slot.distance_ < distance) {
+      return -1;
+    }
+    if (slot.item_.first == key) {
+      return static_cast<int64_t>(index);
+    }
+  }
+}
+
+template <typename K, typename V>
+auto RobinHoodHashTable<K, V>::Find(const K &key, V &value) -> bool {
+  std::scoped_lock<std::mutex> locker(latch_);
+  int64_t index = Locate(key);
+  if (index < 0) {
+    return false;
+  }
+  value = slots_[index].item_.second;
+  return true;
+}
+
+template <typename K, typename V>
+auto RobinHoodHashTable<K, V>::Remove(const K &key) -> bool {
+  std::scoped_lock<std::mutex> locker(latch_);
+  int64_t found = Locate(key);
+  if (found < 0) {
+    return false;
+  }
+  // Backward-shift deletion: pull every following displaced entry one slot closer to home
+  size_t index = static_cast<size_t>(found);
+  size_t next = (index + 1) & Mask();
+  while (slots_[next].distance_ != EMPTY && slots_[next].distance_ > 0) {
+    slots_[index].item_ = std::move(slots_[next].item_);
+    slots_[index].distance_ = slots_[next].distance_ - 1;
+    index = next;
+    next = (next + 1) & Mask();
+  }
+  slots_[index].distance_ = EMPTY;
+  size_--;
+  return true;
+}
+
+template <typename K, typename V>
+void RobinHoodHashTable<K, V>::Insert(const K &key, const V &value) {
+  std::scoped_lock<std::mutex> locker(latch_);
+  int64_t index = Locate(key);
+  if (index >= 0) {
+    slots_[index].item_.second = value;
+    return;
+  }
+  if (static_cast<double>(size_ + 1) > max_load_factor_ * static_cast<double>(slots_.size())) {
+    Grow();
+  }
+  InsertNew({key, value});
+}
+
+template <typename K, typename V>
+void RobinHoodHashTable<K, V>::InsertNew(std::pair<K, V> item) {
+  size_t index = HashKey(item.first) & Mask();
+  uint32_t distance = 0;
+  while (true) {
+    Slot &slot = slots_[index];
+    if (slot.distance_ == EMPTY) {
+      slot.item_ = std::move(item);
+      slot.distance_ = distance;
+      size_++;
+      return;
+    }
+    // 劫富济贫：当前元素离家更远，就抢占这个槽，继续为被换出的元素找位置
+    if (slot.distance_ < distance) {
+      std::swap(slot.item_, item);
+      std::swap(slot.distance_, distance);
+    }
+    distance++;
+    index = (index + 1) & Mask();
+  }
+}
+
+template <typename K, typename V>
+void RobinHoodHashTable<K, V>::Grow() {
+  std::vector<Slot> old_slots(slots_.size() * 2);
+  slots_.swap(old_slots);
+  size_ = 0;
+  for (auto &slot : old_slots) {
+    if (slot.distance_ != EMPTY) {
+      InsertNew(std::move(slot.item_));
+    }
+  }
+}
+
+template class RobinHoodHashTable<page_id_t, Page *>;
+template class RobinHoodHashTable<int, int>;
+template class RobinHoodHashTable<int, std::string>;
+template class RobinHoodHashTable<int, std::list<int>::iterator>;
+
+}  // namespace bustub
@@ -0,0 +1,117 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// robin_hood_hash_table.h
+//
+// Identification: src/include/container/hash/robin_hood_hash_table.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+/**
+ * robin_hood_hash_table.h
+ *
+ * Implementation of in-memory hash table using Robin Hood linear probing
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "container/hash/hash_mix.h"
+#include "container/hash/hash_table.h"
+
+namespace bustub {
+
+/**
+ * RobinHoodHashTable is a linear-probing hash table that keeps probe sequences short and predictable.
+ *
+ * Each slot remembers how far its entry sits from its home slot (probe distance). An insert that meets an
+ * entry closer to home than itself swaps places with it ("takes from the rich"), which keeps the
+ * variance of probe distances low. Because distances along a run are ordered, a lookup can stop as soon
+ * as it sees an entry closer to home than the distance probed so far, so misses are cheap. Deletes
+ * shift the following entries back by one instead of leaving tombstones.
+ *
+ * @tparam K key type
+ * @tparam V value type
+ */
+template <typename K, typename V>
+class RobinHoodHashTable : public HashTable<K, V> {
+ public:
+  /**
+   * @brief Create a new RobinHoodHashTable.
+   * @param initial_capacity number of slots to start with, rounded up to a power of two
+   * @param max_load_factor the table doubles when an insert would exceed this load factor
+   */
+  explicit RobinHoodHashTable(size_t initial_capacity = 64, double max_load_factor = 0.9);
+
+  /**
+   * @brief Get the number of slots in the table.
+   * @return The number of slots.
+   */
+  auto GetCapacity() const -> size_t;
+
+  /**
+   * @brief Get the longest probe distance of any entry currently in the table.
+   * @return The maximum probe distance.
+   */
+  auto GetMaxProbeDistance() const -> size_t;
+
+  /**
+   * @brief Find the value associated with the given key.
+   * @param key The key to be searched.
+   * @param[out] value The value associated with the key.
+   * @return True if the key is found, false otherwise.
+   */
+  auto Find(const K &key, V &value) -> bool override;
+
+  /**
+   * @brief Insert the given key-value pair into the hash table.
+   * If a key already exists, the value should be updated.
+   * @param key The key to be inserted.
+   * @param value The value to be inserted.
+   */
+  void Insert(const K &key, const V &value) override;
+
+  /**
+   * @brief Given the key, remove the corresponding key-value pair in the hash table.
+   * @param key The key to be deleted.
+   * @return True if the key exists, false otherwise.
+   */
+  auto Remove(const K &key) -> bool override;
+
+ private:
+  /** Probe distance value of an empty slot. */
+  static constexpr uint32_t EMPTY = UINT32_MAX;
+
+  struct Slot {
+    uint32_t distance_{EMPTY};
+    std::pair<K, V> item_;
+  };
+
+  double max_load_factor_;
+  size_t size_{0};
+  mutable std::mutex latch_;
+  std::vector<Slot> slots_;
+
+  /*****************************************************************
+   * Must acquire latch_ first before calling the below functions. *
+   *****************************************************************/
+
+  auto Mask() const -> size_t { return slots_.size() - 1; }
+
+  /** @brief Return the slot holding the key, or -1. Stops at the first slot closer to home than the probe. */
+  auto Locate(const K &key) const -> int64_t;
+
+  /** @brief Place a key known to be absent, displacing richer entries along the way. */
+  void InsertNew(std::pair<K, V> item);
+
+  /** @brief Double the table and reinsert every entry. */
+  void Grow();
+};
+
+}  // namespace bustub
@@ -0,0 +1,157 @@
+#include "buffer/s3fifo_replacer.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace bustub {
+
+S3FIFOReplacer::S3FIFOReplacer(size_t num_frames)
+    : replacer_size_(num_frames),
+      small_target_(std::max<size_t>(1, num_frames / 10)),
+      ghost_capacity_(num_frames - std::min(num_frames, small_target_)),
+      frames_(new FrameState[num_frames]),
+      lists_(num_frames + 2) {}
+
+auto S3FIFOReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::lock_guard<std::mutex> guard(latch_);
+  if (curr_size_ == 0) {
+    return false;
+  }
+  // Pinned frames with a zero counter are rotated past; once a queue was skipped entirely, walk the other one
+  size_t skipped_small = 0;
+  size_t skipped_main = 0;
+  while (true) {
+    bool small_exhausted = small_count_ == 0 || skipped_small >= small_count_;
+    bool main_exhausted = main_count_ == 0 || skipped_main >= main_count_;
+    if (small_exhausted && main_exhausted) {
+      // 两个队列都只剩被 pin 的帧被跳过；可驱逐帧的计数器在主队列里还会继续递减
+      skipped_small = skipped_main = 0;
+      continue;
+    }
+    bool use_small = !small_exhausted && (small_count_ >= small_target_ || main_exhausted);
+    size_t sentinel = use_small ? SmallSentinel() : MainSentinel();
+    size_t node = lists_.Front(sentinel);
+    FrameState &frame = frames_[node];
+    lists_.Unlink(node);
+    uint8_t freq = frame.freq_.load(std::memory_order_relaxed);
+
+    if (use_small && freq > 0) {
+      // 在小队列里被再次访问过，晋升到主队列
+      frame.freq_.store(0, std::memory_order_relaxed);
+      frame.in_main_ = true;
+      small_count_--;
+      main_count_++;
+      lists_.LinkBefore(node, MainSentinel());
+      continue;
+    }
+    if (!use_small && freq > 0) {
+      // Concurrent hits may have raised the counter since the load; they only make it survive longer
+      frame.freq_.fetch_sub(1, std::memory_order_relaxed);
+      lists_.LinkBefore(node, MainSentinel());
+      continue;
+    }
+    if (!frame.evictable_) {
+      lists_.LinkBefore(node, sentinel);
+      (use_small ? skipped_small : skipped_main)++;
+      continue;
+    }
+
+    if (use_small) {
+      AddGhost(frame.page_id_);
+    }
+    Untrack(static_cast<frame_id_t>(node));
+    *frame_id = static_cast<frame_id_t>(node);
+    return true;
+  }
+}
+
+void S3FIFOReplacer::RecordAccess(frame_id_t frame_id, page_id_t page_id) {
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  FrameState &frame = frames_[frame_id];
+  if (frame.tracked_.load(std::memory_order_acquire)) {
+    // 命中路径：只对 2 位计数器做饱和自增，不加锁也不移动链表
+    uint8_t freq = frame.freq_.load(std::memory_order_relaxed);
+    while (freq < MAX_FREQ && !frame.freq_.compare_exchange_weak(freq, freq + 1, std::memory_order_relaxed)) {
+    }
+    return;
+  }
+
+  std::lock_guard<std::mutex> guard(latch_);
+  if (frame.tracked_.load(std::memory_order_relaxed)) {
+    return;
+  }
+  frame.freq_.store(0, std::memory_order_relaxed);
+  frame.page_id_ = page_id;
+  auto ghost = page_id == INVALID_PAGE_ID ? ghost_index_.end() : ghost_index_.find(page_id);
+  frame.in_main_ = ghost != ghost_index_.end();
+  if (frame.in_main_) {
+    ghost_.erase(ghost->second);
+    ghost_index_.erase(ghost);
+    main_count_++;
+    lists_.LinkBefore(frame_id, MainSentinel());
+  } else {
+    small_count_++;
+    lists_.LinkBefore(frame_id, SmallSentinel());
+  }
+  frame.tracked_.store(true, std::memory_order_release);
+}
+
+void S3FIFOReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::lock_guard<std::mutex> guard(latch_);
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  FrameState &frame = frames_[frame_id];
+  if (!frame.tracked_.load(std::memory_order_relaxed) || frame.evictable_ == set_evictable) {
+    return;
+  }
+  frame.evictable_ = set_evictable;
+  if (set_evictable) {
+    curr_size_++;
+  } else {
+    curr_size_--;
+  }
+}
+
+void S3FIFOReplacer::Remove(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  FrameState &frame = frames_[frame_id];
+  if (!frame.tracked_.load(std::memory_order_relaxed) || !frame.evictable_) {
+    return;
+  }
+  lists_.Unlink(frame_id);
+  Untrack(frame_id);
+}
+
+auto S3FIFOReplacer::Size() -> size_t {
+  std::lock_guard<std::mutex> guard(latch_);
+  return curr_size_;
+}
+
+void S3FIFOReplacer::Untrack(frame_id_t frame_id) {
+  FrameState &frame = frames_[frame_id];
+  if (frame.in_main_) {
+    main_count_--;
+  } else {
+    small_count_--;
+  }
+  frame.tracked_.store(false, std::memory_order_relaxed);
+  frame.freq_.store(0, std::memory_order_relaxed);
+  frame.evictable_ = false;
+  frame.in_main_ = false;
+  frame.page_id_ = INVALID_PAGE_ID;
+  curr_size_--;
+}
+
+void S3FIFOReplacer::AddGhost(page_id_t page_id) {
+  if (page_id == INVALID_PAGE_ID || ghost_capacity_ == 0 || ghost_index_.count(page_id) != 0) {
+    return;
+  }
+  if (ghost_.size() == ghost_capacity_) {
+    ghost_index_.erase(ghost_.front());
+    ghost_.pop_front();
+  }
+  ghost_.push_back(page_id);
+  ghost_index_[page_id] = std::prev(ghost_.end());
+}
+
+}  // namespace bustub
@@ -0,0 +1,134 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// s3fifo_replacer.h
+//
+// Identification: src/include/buffer/s3fifo_replacer.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/intrusive_lists.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * S3FIFOReplacer implements the S3-FIFO replacement policy with three FIFO queues.
+ *
+ * A new frame enters the small queue (about 10% of the frames), unless its page was evicted recently, in
+ * which case it goes straight to the main queue. Each frame has a 2-bit access counter. Evict walks the
+ * small queue while it is over its share: a frame accessed since insertion moves to main, an unaccessed one
+ * is evicted and its page id remembered in the ghost queue. Otherwise Evict walks main, where a frame with a
+ * non-zero counter is decremented and reinserted at the tail (CLOCK-like), and one at zero is evicted.
+ * Pages read once by a scan leave through the small queue without touching main.
+ *
+ * Recording an access to a frame that is already tracked only increments its atomic counter: it takes no
+ * latch and moves nothing. Pinned frames stay in their queue and are skipped by the walk.
+ */
+class S3FIFOReplacer {
+ public:
+  /**
+   * Constructor for S3FIFOReplacer.
+   *
+   * @param num_frames the maximum number of frames the S3FIFOReplacer will be required to store
+   */
+  explicit S3FIFOReplacer(size_t num_frames);
+
+  DISALLOW_COPY_AND_MOVE(S3FIFOReplacer);
+
+  /**
+   * Destroys the S3FIFOReplacer.
+   */
+  ~S3FIFOReplacer() = default;
+
+  /**
+   * Walk the small or main queue as described above and evict the first suitable evictable frame.
+   *
+   * @param[out] frame_id id of frame that is evicted.
+   * @return true if a frame is evicted successfully, false if no frames can be evicted.
+   */
+  auto Evict(frame_id_t *frame_id) -> bool;
+
+  /**
+   * Record an access to the given frame. A frame seen for the first time is queued, the others only have
+   * their counter incremented.
+   *
+   * @param frame_id id of frame that received a new access.
+   * @param page_id page held by the frame, used to recognize recently evicted pages; INVALID_PAGE_ID to skip
+   */
+  void RecordAccess(frame_id_t frame_id, page_id_t page_id = INVALID_PAGE_ID);
+
+  /**
+   * Toggle whether a frame is evictable or non-evictable.
+   *
+   * @param frame_id id of frame whose 'evictable' status will be modified
+   * @param set_evictable whether the given frame is evictable or not
+   */
+  void SetEvictable(frame_id_t frame_id, bool set_evictable);
+
+  /**
+   * Remove an evictable frame from replacer. Its page is not remembered in the ghost queue.
+   *
+   * @param frame_id id of frame to be removed
+   */
+  void Remove(frame_id_t frame_id);
+
+  /**
+   * Return replacer's size, which tracks the number of evictable frames.
+   *
+   * @return size_t
+   */
+  auto Size() -> size_t;
+
+ private:
+  static constexpr uint8_t MAX_FREQ = 3;
+
+  /** Per-frame state. tracked_ and freq_ are read by the latch-free hit path, the rest is guarded by latch_. */
+  struct FrameState {
+    std::atomic<bool> tracked_{false};
+    std::atomic<uint8_t> freq_{0};
+    bool evictable_{false};
+    bool in_main_{false};
+    page_id_t page_id_{INVALID_PAGE_ID};
+  };
+
+  /*****************************************************************
+   * Must acquire latch_ first before calling the below functions. *
+   *****************************************************************/
+
+  auto SmallSentinel() const -> size_t { return replacer_size_; }
+  auto MainSentinel() const -> size_t { return replacer_size_ + 1; }
+
+  /** @brief Forget a tracked frame that was already unlinked. */
+  void Untrack(frame_id_t frame_id);
+
+  /** @brief Remember the page of an evicted frame, dropping the oldest ghost when the queue is full. */
+  void AddGhost(page_id_t page_id);
+
+  size_t replacer_size_;
+  size_t small_target_;    // the small queue gets walked while it holds at least this many frames
+  size_t ghost_capacity_;  // as many page ids as the main queue has frames
+  size_t small_count_{0};
+  size_t main_count_{0};
+  size_t curr_size_{0};
+  std::unique_ptr<FrameState[]> frames_;
+  IntrusiveLists lists_;  // frames, then the small and main sentinels; front is the oldest
+  std::list<page_id_t> ghost_;
+  std::unordered_map<page_id_t, std::list<page_id_t>::iterator> ghost_index_;
+  std::mutex latch_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,237 @@
+#include "buffer/shadow_policy_evaluator.h"
+
+#include <algorithm>
+#include <iterator>
+#include <list>
+#include <set>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+
+namespace bustub {
+
+namespace {
+
+/** LRU-K on page ids; pages with fewer than k accesses go first, in order of their first access. */
+class ShadowLRUK : public ShadowPolicy {
+ public:
+  ShadowLRUK(size_t capacity, size_t k) : capacity_(capacity), k_(k) {}
+
+  auto Access(page_id_t page_id) -> bool override {
+    size_t now = current_timestamp_++;
+    auto it = pages_.find(page_id);
+    bool hit = it != pages_.end();
+    if (hit) {
+      order_.erase(KeyOf(page_id, it->second));
+    } else {
+      if (pages_.size() == capacity_) {
+        page_id_t victim = std::get<2>(*order_.begin());
+        order_.erase(order_.begin());
+        pages_.erase(victim);
+      }
+      it = pages_.emplace(page_id, std::vector<size_t>()).first;
+    }
+    std::vector<size_t> &history = it->second;
+    history.push_back(now);
+    if (history.size() > k_) {
+      history.erase(history.begin());
+    }
+    order_.insert(KeyOf(page_id, history));
+    return hit;
+  }
+
+  void Erase(page_id_t page_id) override {
+    auto it = pages_.find(page_id);
+    if (it != pages_.end()) {
+      order_.erase(KeyOf(page_id, it->second));
+      pages_.erase(it);
+    }
+  }
+
+  auto GetName() const -> std::string override { return "LRU-" + std::to_string(k_); }
+
+ private:
+  using Key = std::tuple<bool, size_t, page_id_t>;
+
+  // 不足 k 次访问的页面排在最前（后向 k 距离为无穷大），按第一次访问排序
+  auto KeyOf(page_id_t page_id, const std::vector<size_t> &history) const -> Key {
+    return {history.size() >= k_, history.front(), page_id};
+  }
+
+  size_t capacity_;
+  size_t k_;
+  size_t current_timestamp_{0};
+  std::unordered_map<page_id_t, std::vector<size_t>> pages_;  // at most the last k access timestamps
+  std::set<Key> order_;
+};
+
+/** Adaptive Replacement Cache (Megiddo and Modha) on page ids. */
+class ShadowARC : public ShadowPolicy {
+ public:
+  explicit ShadowARC(size_t capacity) : capacity_(capacity) {}
+
+  auto Access(page_id_t page_id) -> bool override {
+    auto it = where_.find(page_id);
+    if (it != where_.end() && (it->second.list_ == T1 || it->second.list_ == T2)) {
+      MoveTo(page_id, T2);
+      return true;
+    }
+    auto c = static_cast<double>(capacity_);
+    if (it != where_.end()) {
+      // 命中幽灵队列：按 B1/B2 的相对大小调整目标 p
+      auto b1 = static_cast<double>(lists_[B1].size());
+      auto b2 = static_cast<double>(lists_[B2].size());
+      if (it->second.list_ == B1) {
+        target_ = std::min(c, target_ + std::max(1.0, b2 / b1));
+      } else {
+        target_ = std::max(0.0, target_ - std::max(1.0, b1 / b2));
+      }
+      bool in_b2 = it->second.list_ == B2;
+      Drop(page_id);
+      if (lists_[T1].size() + lists_[T2].size() >= capacity_) {
+        Replace(in_b2);
+      }
+      Push(page_id, T2);
+      return false;
+    }
+
+    size_t l1 = lists_[T1].size() + lists_[B1].size();
+    size_t total = l1 + lists_[T2].size() + lists_[B2].size();
+    if (l1 >= capacity_) {
+      if (lists_[T1].size() < capacity_) {
+        Drop(lists_[B1].front());
+        if (lists_[T1].size() + lists_[T2].size() >= capacity_) {
+          Replace(false);
+        }
+      } else {
+        Drop(lists_[T1].front());
+      }
+    } else if (total >= capacity_) {
+      if (total >= 2 * capacity_) {
+        Drop(lists_[B2].front());
+      }
+      if (lists_[T1].size() + lists_[T2].size() >= capacity_) {
+        Replace(false);
+      }
+    }
+    Push(page_id, T1);
+    return false;
+  }
+
+  void Erase(page_id_t page_id) override {
+    auto it = where_.find(page_id);
+    if (it != where_.end() && (it->second.list_ == T1 || it->second.list_ == T2)) {
+      Drop(page_id);
+    }
+  }
+
+  auto GetName() const -> std::string override { return "ARC"; }
+
+ private:
+  enum ListId { T1 = 0, T2, B1, B2 };
+
+  struct Position {
+    ListId list_;
+    std::list<page_id_t>::iterator it_;
+  };
+
+  /** Evict the LRU page of T1 or T2 into the matching ghost list. */
+  void Replace(bool in_b2) {
+    auto t1 = static_cast<double>(lists_[T1].size());
+    bool from_t1 = !lists_[T1].empty() && ((in_b2 && t1 == target_) || t1 > target_);
+    if (!from_t1 && lists_[T2].empty()) {
+      from_t1 = true;
+    }
+    MoveTo(lists_[from_t1 ? T1 : T2].front(), from_t1 ? B1 : B2);
+  }
+
+  void Push(page_id_t page_id, ListId list) {
+    lists_[list].push_back(page_id);
+    where_[page_id] = {list, std::prev(lists_[list].end())};
+  }
+
+  void Drop(page_id_t page_id) {
+    auto it = where_.find(page_id);
+    lists_[it->second.list_].erase(it->second.it_);
+    where_.erase(it);
+  }
+
+  void MoveTo(page_id_t page_id, ListId list) {
+    Drop(page_id);
+    Push(page_id, list);
+  }
+
+  size_t capacity_;
+  double target_{0};                // target size p of T1
+  std::list<page_id_t> lists_[4];  // front is least recently used
+  std::unordered_map<page_id_t, Position> where_;
+};
+
+}  // namespace
+
+ShadowPolicyEvaluator::ShadowPolicyEvaluator(size_t num_frames, uint32_t sample_shift)
+    : sample_shift_(sample_shift), shadow_frames_(std::max<size_t>(1, num_frames >> sample_shift)) {}
+
+void ShadowPolicyEvaluator::AddLRUKPolicy(size_t k) {
+  std::scoped_lock<std::mutex> locker(latch_);
+  policies_.push_back(std::make_unique<ShadowLRUK>(shadow_frames_, k));
+  stats_.policies_.push_back({policies_.back()->GetName(), 0});
+}
+
+void ShadowPolicyEvaluator::AddARCPolicy() {
+  std::scoped_lock<std::mutex> locker(latch_);
+  policies_.push_back(std::make_unique<ShadowARC>(shadow_frames_));
+  stats_.policies_.push_back({policies_.back()->GetName(), 0});
+}
+
+auto ShadowPolicyEvaluator::IsSampled(page_id_t page_id) const -> bool {
+  // 页号常常是连续或等步长的，先打散再取低位，避免采样偏向某种步长
+  // The seed keeps page 0, usually a hot header page, from always being sampled (the mix maps 0 to 0)
+  auto h = static_cast<uint32_t>(page_id) ^ 0x9e3779b9U;
+  h ^= h >> 16;
+  h *= 0x85ebca6bU;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35U;
+  h ^= h >> 16;
+  return (h & ((uint32_t{1} << sample_shift_) - 1)) == 0;
+}
+
+void ShadowPolicyEvaluator::RecordAccess(page_id_t page_id, bool live_hit) {
+  if (page_id == INVALID_PAGE_ID || !IsSampled(page_id)) {
+    return;
+  }
+  std::unique_lock<std::mutex> locker(latch_, std::try_to_lock);
+  if (!locker.owns_lock()) {
+    // Dropping the access from the live count and every shadow alike keeps the hit ratios comparable
+    dropped_accesses_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  stats_.sampled_accesses_++;
+  if (live_hit) {
+    stats_.live_hits_++;
+  }
+  for (size_t i = 0; i < policies_.size(); i++) {
+    if (policies_[i]->Access(page_id)) {
+      stats_.policies_[i].hits_++;
+    }
+  }
+}
+
+void ShadowPolicyEvaluator::RecordRemove(page_id_t page_id) {
+  if (page_id == INVALID_PAGE_ID || !IsSampled(page_id)) {
+    return;
+  }
+  std::scoped_lock<std::mutex> locker(latch_);
+  for (auto &policy : policies_) {
+    policy->Erase(page_id);
+  }
+}
+
+auto ShadowPolicyEvaluator::GetStats() -> ShadowPolicyStats {
+  std::scoped_lock<std::mutex> locker(latch_);
+  ShadowPolicyStats stats = stats_;
+  stats.dropped_accesses_ = dropped_accesses_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+}  // namespace bustub
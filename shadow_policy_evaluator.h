@@ -0,0 +1,125 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// shadow_policy_evaluator.h
+//
+// Identification: src/include/buffer/shadow_policy_evaluator.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * A replacement policy simulated on page ids only, without frames or pins.
+ */
+class ShadowPolicy {
+ public:
+  virtual ~ShadowPolicy() = default;
+
+  /**
+   * @brief Simulate an access to a page, loading it (and evicting another page) on a miss.
+   * @return true if the page was cached
+   */
+  virtual auto Access(page_id_t page_id) -> bool = 0;
+
+  /** @brief Drop a page that was deleted from the buffer pool, if it is cached. */
+  virtual void Erase(page_id_t page_id) = 0;
+
+  /** @brief Name of the policy in stats, e.g. "LRU-2". */
+  virtual auto GetName() const -> std::string = 0;
+};
+
+/** Hit counts of the live replacer and of every shadow policy on the sampled pages. */
+struct ShadowPolicyStats {
+  struct PolicyHits {
+    std::string name_;
+    uint64_t hits_;
+  };
+
+  uint64_t sampled_accesses_{0};
+  uint64_t dropped_accesses_{0};  // sampled accesses skipped because the evaluator was busy
+  uint64_t live_hits_{0};
+  std::vector<PolicyHits> policies_;
+
+  auto GetLiveHitRate() const -> double {
+    return sampled_accesses_ == 0 ? 0 : static_cast<double>(live_hits_) / static_cast<double>(sampled_accesses_);
+  }
+
+  auto GetHitRate(size_t policy) const -> double {
+    return sampled_accesses_ == 0
+               ? 0
+               : static_cast<double>(policies_[policy].hits_) / static_cast<double>(sampled_accesses_);
+  }
+};
+
+/**
+ * ShadowPolicyEvaluator estimates how other replacement policies would do on the live access stream.
+ *
+ * Pages are sampled by a hash of their page id (1 in 2^sample_shift), so a sampled page contributes all of
+ * its accesses. Every shadow policy gets a cache scaled down by the same factor, which keeps its hit ratio
+ * comparable to that of the full buffer pool (spatial sampling). The live replacer reports for each access
+ * whether the page was already buffered, so the live hit ratio is measured on the same sample.
+ *
+ * Overhead is bounded by the sample rate: unsampled accesses cost one hash, and a sampled access that finds
+ * the evaluator busy is dropped instead of waiting.
+ */
+class ShadowPolicyEvaluator {
+ public:
+  /**
+   * @param num_frames number of frames of the live buffer pool
+   * @param sample_shift sample 1 in 2^sample_shift pages
+   */
+  explicit ShadowPolicyEvaluator(size_t num_frames, uint32_t sample_shift = 6);
+
+  DISALLOW_COPY_AND_MOVE(ShadowPolicyEvaluator);
+
+  ~ShadowPolicyEvaluator() = default;
+
+  /** @brief Add a shadow LRU-K policy. */
+  void AddLRUKPolicy(size_t k);
+
+  /** @brief Add a shadow ARC policy. */
+  void AddARCPolicy();
+
+  /** @brief Get the number of frames each shadow policy simulates. */
+  auto GetShadowFrames() const -> size_t { return shadow_frames_; }
+
+  /**
+   * @brief Mirror one access of the live buffer pool.
+   * @param page_id the accessed page
+   * @param live_hit whether the live buffer pool already held the page
+   */
+  void RecordAccess(page_id_t page_id, bool live_hit);
+
+  /** @brief Mirror the deletion of a page; called by the buffer pool manager when it deletes a page. */
+  void RecordRemove(page_id_t page_id);
+
+  auto GetStats() -> ShadowPolicyStats;
+
+ private:
+  auto IsSampled(page_id_t page_id) const -> bool;
+
+  uint32_t sample_shift_;
+  size_t shadow_frames_;
+  std::mutex latch_;
+  std::vector<std::unique_ptr<ShadowPolicy>> policies_;
+  ShadowPolicyStats stats_;
+  std::atomic<uint64_t> dropped_accesses_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,238 @@
+#include "container/hash/shared_hash_table.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <functional>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+namespace {
+/** Layout of the control segment. */
+struct Control {
+  std::atomic<uint64_t> version_;
+};
+
+auto MapControl(const std::string &name, bool create) -> Control * {
+  int fd = shm_open(name.c_str(), create ? O_RDWR | O_CREAT : O_RDWR, 0644);
+  if (fd < 0) {
+    if (!create && errno == ENOENT) {
+      return nullptr;
+    }
+    throw Exception("can't open shared memory " + name + ": " + std::string(strerror(errno)));
+  }
+  // A freshly created segment is zero-filled, i.e. version 0 (nothing published)
+  if (create && ftruncate(fd, sizeof(Control)) != 0) {
+    close(fd);
+    throw Exception("can't size shared memory " + name + ": " + std::string(strerror(errno)));
+  }
+  void *addr = mmap(nullptr, sizeof(Control), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    throw Exception("can't map shared memory " + name + ": " + std::string(strerror(errno)));
+  }
+  return static_cast<Control *>(addr);
+}
+}  // namespace
+
+template <typename K, typename V>
+auto SharedHashTable<K, V>::VersionName(const std::string &name, uint64_t version) -> std::string {
+  return name + "." + std::to_string(version);
+}
+
+template <typename K, typename V>
+auto SharedHashTable<K, V>::CurrentVersion(const std::string &name) -> uint64_t {
+  Control *control = MapControl(name, false);
+  if (control == nullptr) {
+    return 0;
+  }
+  uint64_t version = control->version_.load(std::memory_order_acquire);
+  munmap(control, sizeof(Control));
+  return version;
+}
+
+template <typename K, typename V>
+auto SharedHashTable<K, V>::Publish(const std::string &name, const std::vector<std::pair<K, V>> &items,
+                                   size_t bucket_size) -> uint64_t {
+  // Deduplicate so that a key appears once; the last occurrence wins like repeated Inserts
+  std::unordered_map<K, size_t> last;
+  for (size_t i = 0; i < items.size(); i++) {
+    last[items[i].first] = i;
+  }
+  uint32_t global_depth = 0;
+  while ((size_t{1} << global_depth) * bucket_size < last.size()) {
+    global_depth++;
+  }
+  size_t num_slots = size_t{1} << global_depth;
+  size_t mask = num_slots - 1;
+
+  // 计算每个目录槽的条目数（CSR 布局），再按槽顺序摆放条目
+  std::vector<uint64_t> dir(num_slots + 1, 0);
+  for (const auto &[key, index] : last) {
+    dir[(std::hash<K>()(key) & mask) + 1]++;
+  }
+  for (size_t i = 0; i < num_slots; i++) {
+    dir[i + 1] += dir[i];
+  }
+
+  Header header{};
+  header.magic_ = MAGIC;
+  header.global_depth_ = global_depth;
+  header.num_entries_ = last.size();
+  header.dir_offset_ = sizeof(Header);
+  header.entries_offset_ = (header.dir_offset_ + dir.size() * sizeof(uint64_t) + alignof(Entry) - 1) /
+                           alignof(Entry) * alignof(Entry);
+  header.total_size_ = header.entries_offset_ + last.size() * sizeof(Entry);
+
+  Control *control = MapControl(name, true);
+  header.version_ = control->version_.load(std::memory_order_acquire) + 1;
+  std::string segment = VersionName(name, header.version_);
+
+  int fd = shm_open(segment.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0 || ftruncate(fd, static_cast<off_t>(header.total_size_)) != 0) {
+    int err = errno;
+    if (fd >= 0) {
+      close(fd);
+    }
+    munmap(control, sizeof(Control));
+    throw Exception("can't create shared memory " + segment + ": " + std::string(strerror(err)));
+  }
+  void *addr = mmap(nullptr, header.total_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    munmap(control, sizeof(Control));
+    throw Exception("can't map shared memory " + segment + ": " + std::string(strerror(errno)));
+  }
+
+  auto *base = static_cast<char *>(addr);
+  memcpy(base, &header, sizeof(Header));
+  memcpy(base + header.dir_offset_, dir.data(), dir.size() * sizeof(uint64_t));
+  auto *entries = reinterpret_cast<Entry *>(base + header.entries_offset_);
+  std::vector<uint64_t> cursor(dir.begin(), dir.end() - 1);
+  for (const auto &[key, index] : last) {
+    entries[cursor[std::hash<K>()(key) & mask]++] = {key, items[index].second};
+  }
+  munmap(addr, header.total_size_);
+
+  // Only a fully written segment becomes visible; the previous one goes away with its last reader
+  control->version_.store(header.version_, std::memory_order_release);
+  munmap(control, sizeof(Control));
+  if (header.version_ > 1) {
+    shm_unlink(VersionName(name, header.version_ - 1).c_str());
+  }
+  return header.version_;
+}
+
+template <typename K, typename V>
+void SharedHashTable<K, V>::Unlink(const std::string &name) {
+  uint64_t version = CurrentVersion(name);
+  if (version > 0) {
+    shm_unlink(VersionName(name, version).c_str());
+  }
+  shm_unlink(name.c_str());
+}
+
+template <typename K, typename V>
+SharedHashTable<K, V>::SharedHashTable(std::string name) : name_(std::move(name)) {
+  MapCurrent();
+}
+
+template <typename K, typename V>
+SharedHashTable<K, V>::~SharedHashTable() {
+  Unmap();
+}
+
+template <typename K, typename V>
+void SharedHashTable<K, V>::Unmap() {
+  if (base_ != nullptr) {
+    munmap(const_cast<void *>(base_), size_);
+    base_ = nullptr;
+    size_ = 0;
+  }
+}
+
+template <typename K, typename V>
+void SharedHashTable<K, V>::MapCurrent() {
+  while (true) {
+    uint64_t version = CurrentVersion(name_);
+    if (version == 0) {
+      throw Exception("no shared hash table published under " + name_);
+    }
+    int fd = shm_open(VersionName(name_, version).c_str(), O_RDONLY, 0);
+    if (fd < 0 && errno == ENOENT) {
+      // A newer version was published and this one unlinked in between; read the version again
+      continue;
+    }
+    if (fd < 0) {
+      throw Exception("can't open shared memory " + name_ + ": " + std::string(strerror(errno)));
+    }
+    struct stat st {};
+    fstat(fd, &st);
+    void *addr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+      throw Exception("can't map shared memory " + name_ + ": " + std::string(strerror(errno)));
+    }
+    const auto *header = static_cast<const Header *>(addr);
+    if (header->magic_ != MAGIC || header->total_size_ != static_cast<uint64_t>(st.st_size)) {
+      munmap(addr, static_cast<size_t>(st.st_size));
+      throw Exception("shared memory " + name_ + " does not hold a hash table");
+    }
+    Unmap();
+    base_ = addr;
+    size_ = static_cast<size_t>(st.st_size);
+    return;
+  }
+}
+
+template <typename K, typename V>
+auto SharedHashTable<K, V>::Refresh() -> bool {
+  std::unique_lock lock(latch_);
+  if (CurrentVersion(name_) == GetHeader()->version_) {
+    return false;
+  }
+  MapCurrent();
+  return true;
+}
+
+template <typename K, typename V>
+auto SharedHashTable<K, V>::GetVersion() const -> uint64_t {
+  std::shared_lock lock(latch_);
+  return GetHeader()->version_;
+}
+
+template <typename K, typename V>
+auto SharedHashTable<K, V>::GetSize() const -> size_t {
+  std::shared_lock lock(latch_);
+  return GetHeader()->num_entries_;
+}
+
+template <typename K, typename V>
+auto SharedHashTable<K, V>::Find(const K &key, V &value) const -> bool {
+  std::shared_lock lock(latch_);
+  const Header *header = GetHeader();
+  const auto *base = static_cast<const char *>(base_);
+  const auto *dir = reinterpret_cast<const uint64_t *>(base + header->dir_offset_);
+  const auto *entries = reinterpret_cast<const Entry *>(base + header->entries_offset_);
+  size_t slot = std::hash<K>()(key) & ((size_t{1} << header->global_depth_) - 1);
+  for (uint64_t i = dir[slot]; i < dir[slot + 1]; i++) {
+    if (entries[i].key_ == key) {
+      value = entries[i].value_;
+      return true;
+    }
+  }
+  return false;
+}
+
+template class SharedHashTable<int, int>;
+
+}  // namespace bustub
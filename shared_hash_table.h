@@ -0,0 +1,138 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// shared_hash_table.h
+//
+// Identification: src/include/container/hash/shared_hash_table.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+/**
+ * shared_hash_table.h
+ *
+ * Read-only hash table laid out in a POSIX shared memory segment, for lookups from many processes
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * SharedHashTable maps a published, read-only hash table into the calling process.
+ *
+ * A writer process builds the table once with Publish(). The layout is position independent: a header,
+ * a directory of 2^global_depth + 1 entry offsets (directory slot i owns entries [dir[i], dir[i+1])) and
+ * a flat entry array, addressed by offsets only, so every process can map it at any address and query it
+ * in place with no copying and no build step. Directory slots are chosen with the same
+ * `std::hash<K>(key) & mask` as ExtendibleHashTable::IndexOf.
+ *
+ * Every version lives in its own segment "<name>.<version>"; a small control segment "<name>" holds the
+ * current version number. Publish() writes a complete new segment and only then bumps the version, so
+ * readers either see the old or the new table, never a partial one. Readers pick up a new version with
+ * Refresh(); the old segment is unlinked and disappears once the last reader unmaps it.
+ *
+ * Keys and values must be trivially copyable, since they are shared as raw bytes between processes.
+ *
+ * @tparam K key type
+ * @tparam V value type
+ */
+template <typename K, typename V>
+class SharedHashTable {
+  static_assert(std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V>,
+                "shared tables store keys and values as raw bytes");
+
+ public:
+  /**
+   * @brief Build a new version of the table and make it current.
+   * @param name shared memory name, e.g. "/page_table"
+   * @param items the key-value pairs of the table; later duplicates of a key win
+   * @param bucket_size target average number of entries per directory slot
+   * @return the version that was published
+   */
+  static auto Publish(const std::string &name, const std::vector<std::pair<K, V>> &items, size_t bucket_size = 4)
+      -> uint64_t;
+
+  /**
+   * @brief Remove the control segment and the current version. Mapped readers keep working.
+   * @param name shared memory name passed to Publish
+   */
+  static void Unlink(const std::string &name);
+
+  /**
+   * Map the current version of a published table read-only.
+   * @param name shared memory name passed to Publish
+   */
+  explicit SharedHashTable(std::string name);
+
+  DISALLOW_COPY_AND_MOVE(SharedHashTable);
+
+  /** Unmaps the table. */
+  ~SharedHashTable();
+
+  /**
+   * @brief Find the value associated with the given key.
+   * @param key The key to be searched.
+   * @param[out] value The value associated with the key.
+   * @return True if the key is found, false otherwise.
+   */
+  auto Find(const K &key, V &value) const -> bool;
+
+  /**
+   * @brief Switch to the newest published version if it changed.
+   * @return true if a new version was mapped
+   */
+  auto Refresh() -> bool;
+
+  /** @brief Get the version currently mapped. */
+  auto GetVersion() const -> uint64_t;
+
+  /** @brief Get the number of entries in the mapped version. */
+  auto GetSize() const -> size_t;
+
+ private:
+  static constexpr uint64_t MAGIC = 0x4253484D54424C31ULL;  // "BSHMTBL1"
+
+  struct Header {
+    uint64_t magic_;
+    uint64_t version_;
+    uint32_t global_depth_;
+    uint32_t reserved_;
+    uint64_t num_entries_;
+    uint64_t dir_offset_;      // byte offset of the directory from the start of the segment
+    uint64_t entries_offset_;  // byte offset of the entry array from the start of the segment
+    uint64_t total_size_;
+  };
+
+  struct Entry {
+    K key_;
+    V value_;
+  };
+
+  static auto VersionName(const std::string &name, uint64_t version) -> std::string;
+  /** @brief Read the current version from the control segment, or 0 if nothing is published. */
+  static auto CurrentVersion(const std::string &name) -> uint64_t;
+
+  /** Must hold latch_ exclusively. Maps the current version; retries if a publish races with it. */
+  void MapCurrent();
+  void Unmap();
+
+  auto GetHeader() const -> const Header * { return static_cast<const Header *>(base_); }
+
+  std::string name_;
+  mutable std::shared_mutex latch_;
+  const void *base_{nullptr};
+  size_t size_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,239 @@
+#include "buffer/skiplist_lru_k_replacer.h"
+
+#include <random>
+#include <unordered_set>
+
+#include "common/epoch_manager.h"
+
+namespace bustub {
+
+namespace {
+auto RandomHeight(int max_level) -> int {
+  thread_local std::mt19937 rng(std::random_device{}());
+  // 每升一层的概率为 1/2
+  uint32_t bits = rng();
+  int height = 1;
+  while (height < max_level && (bits & 1) != 0) {
+    height++;
+    bits >>= 1;
+  }
+  return height;
+}
+}  // namespace
+
+SkipListLRUKReplacer::SkipListLRUKReplacer(size_t num_frames, size_t k)
+    : replacer_size_(num_frames), k_(k), frames_(new FrameState[num_frames]) {
+  for (size_t i = 0; i < num_frames; i++) {
+    frames_[i].history_.resize(k_);
+  }
+  head_ = new Node{0, -1, MAX_LEVEL, {MAX_LEVEL}, {}};
+  for (auto &next : head_->next_) {
+    next.store(0);
+  }
+}
+
+SkipListLRUKReplacer::~SkipListLRUKReplacer() {
+  // A node can still be linked on some levels after leaving level 0, so collect it from every level
+  std::unordered_set<Node *> nodes;
+  for (int level = 0; level < MAX_LEVEL; level++) {
+    for (Node *node = ToNode(head_->next_[level].load()); node != nullptr; node = ToNode(node->next_[level].load())) {
+      nodes.insert(node);
+    }
+  }
+  for (Node *node : nodes) {
+    delete node;
+  }
+  delete head_;
+}
+
+auto SkipListLRUKReplacer::Evict(frame_id_t *frame_id) -> bool {
+  EpochGuard guard;
+  Node *preds[MAX_LEVEL];
+  Node *succs[MAX_LEVEL];
+  while (true) {
+    // 沿最底层找第一个未被标记的节点，即后向 k 距离最大的可驱逐帧
+    Node *victim = ToNode(head_->next_[0].load());
+    while (victim != nullptr && IsMarked(victim->next_[0].load())) {
+      victim = ToNode(victim->next_[0].load());
+    }
+    if (victim == nullptr) {
+      return false;
+    }
+    if (!Claim(victim)) {
+      continue;
+    }
+    Find(victim->key_, victim->frame_id_, preds, succs);
+
+    FrameState &frame = frames_[victim->frame_id_];
+    std::scoped_lock<std::mutex> locker(frame.latch_);
+    if (frame.node_ != victim || !frame.evictable_) {
+      // Requeued, pinned or removed after we found the node; the claim only removed a stale node
+      continue;
+    }
+    frame.node_ = nullptr;
+    frame.accesses_ = 0;
+    frame.evictable_ = false;
+    curr_size_.fetch_sub(1);
+    *frame_id = victim->frame_id_;
+    return true;
+  }
+}
+
+void SkipListLRUKReplacer::RecordAccess(frame_id_t frame_id) {
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  EpochGuard guard;
+  FrameState &frame = frames_[frame_id];
+  std::scoped_lock<std::mutex> locker(frame.latch_);
+  frame.history_[frame.accesses_ % k_] = current_timestamp_.fetch_add(1);
+  frame.accesses_++;
+  // A frame with fewer than k accesses keeps its key, i.e. stays ordered by its earliest access
+  if (frame.evictable_ && frame.accesses_ >= k_) {
+    Requeue(frame_id);
+  }
+}
+
+void SkipListLRUKReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  EpochGuard guard;
+  FrameState &frame = frames_[frame_id];
+  std::scoped_lock<std::mutex> locker(frame.latch_);
+  if (frame.accesses_ == 0 || frame.evictable_ == set_evictable) {
+    return;
+  }
+  frame.evictable_ = set_evictable;
+  if (set_evictable) {
+    frame.node_ = Insert(frame_id, KeyOf(frame));
+    curr_size_.fetch_add(1);
+  } else {
+    Requeue(frame_id);
+    curr_size_.fetch_sub(1);
+  }
+}
+
+void SkipListLRUKReplacer::Remove(frame_id_t frame_id) {
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  EpochGuard guard;
+  FrameState &frame = frames_[frame_id];
+  std::scoped_lock<std::mutex> locker(frame.latch_);
+  if (frame.accesses_ == 0 || !frame.evictable_) {
+    return;
+  }
+  frame.evictable_ = false;
+  Requeue(frame_id);
+  frame.accesses_ = 0;
+  curr_size_.fetch_sub(1);
+}
+
+auto SkipListLRUKReplacer::Size() -> size_t { return curr_size_.load(); }
+
+auto SkipListLRUKReplacer::KeyOf(const FrameState &frame) const -> uint64_t {
+  if (frame.accesses_ < k_) {
+    return frame.history_[0];
+  }
+  return HISTORY_CLASS | frame.history_[(frame.accesses_ - k_) % k_];
+}
+
+void SkipListLRUKReplacer::Requeue(frame_id_t frame_id) {
+  FrameState &frame = frames_[frame_id];
+  if (frame.node_ != nullptr) {
+    // 如果驱逐线程已经抢先标记了旧节点，它拿到帧锁后会发现 node_ 已变化并放弃
+    Node *preds[MAX_LEVEL];
+    Node *succs[MAX_LEVEL];
+    Node *old = frame.node_;
+    Claim(old);
+    Find(old->key_, old->frame_id_, preds, succs);
+    frame.node_ = nullptr;
+  }
+  if (frame.evictable_) {
+    frame.node_ = Insert(frame_id, KeyOf(frame));
+  }
+}
+
+void SkipListLRUKReplacer::Find(uint64_t key, frame_id_t frame_id, Node **preds, Node **succs) {
+retry:
+  Node *pred = head_;
+  for (int level = MAX_LEVEL - 1; level >= 0; level--) {
+    Node *curr = ToNode(pred->next_[level].load());
+    while (curr != nullptr) {
+      uintptr_t succ = curr->next_[level].load();
+      if (IsMarked(succ)) {
+        // Unlink the marked node at this level; if pred changed or got marked itself, start over
+        auto expected = reinterpret_cast<uintptr_t>(curr);
+        if (!pred->next_[level].compare_exchange_strong(expected, succ & ~static_cast<uintptr_t>(1))) {
+          goto retry;
+        }
+        ReleaseLevels(curr, 1);
+        curr = ToNode(succ);
+        continue;
+      }
+      if (!Less(curr, key, frame_id)) {
+        break;
+      }
+      pred = curr;
+      curr = ToNode(succ);
+    }
+    preds[level] = pred;
+    succs[level] = curr;
+  }
+}
+
+auto SkipListLRUKReplacer::Insert(frame_id_t frame_id, uint64_t key) -> Node * {
+  int height = RandomHeight(MAX_LEVEL);
+  auto *node = new Node{key, frame_id, height, {height}, {}};
+  Node *preds[MAX_LEVEL];
+  Node *succs[MAX_LEVEL];
+  while (true) {
+    Find(key, frame_id, preds, succs);
+    for (int level = 0; level < height; level++) {
+      node->next_[level].store(reinterpret_cast<uintptr_t>(succs[level]));
+    }
+    // 最底层链接成功即插入生效，上层只是索引
+    auto expected = reinterpret_cast<uintptr_t>(succs[0]);
+    if (preds[0]->next_[0].compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(node))) {
+      break;
+    }
+  }
+  for (int level = 1; level < height; level++) {
+    while (true) {
+      uintptr_t next = node->next_[level].load();
+      if (IsMarked(next)) {
+        // Claimed by an evictor while we were still linking; the remaining levels are never linked
+        ReleaseLevels(node, height - level);
+        return node;
+      }
+      auto succ = reinterpret_cast<uintptr_t>(succs[level]);
+      if (next != succ && !node->next_[level].compare_exchange_strong(next, succ)) {
+        continue;
+      }
+      auto expected = succ;
+      if (preds[level]->next_[level].compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(node))) {
+        break;
+      }
+      Find(key, frame_id, preds, succs);
+    }
+  }
+  return node;
+}
+
+auto SkipListLRUKReplacer::Claim(Node *node) -> bool {
+  for (int level = node->height_ - 1; level >= 1; level--) {
+    uintptr_t next = node->next_[level].load();
+    while (!IsMarked(next) && !node->next_[level].compare_exchange_weak(next, next | 1)) {
+    }
+  }
+  uintptr_t next = node->next_[0].load();
+  while (!IsMarked(next)) {
+    if (node->next_[0].compare_exchange_weak(next, next | 1)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void SkipListLRUKReplacer::ReleaseLevels(Node *node, int levels) {
+  if (node->linked_levels_.fetch_sub(levels) == levels) {
+    EpochManager::Instance().Retire(node, [](void *ptr) { delete static_cast<Node *>(ptr); });
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,149 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// skiplist_lru_k_replacer.h
+//
+// Identification: src/include/buffer/skiplist_lru_k_replacer.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * SkipListLRUKReplacer implements the LRU-k policy without a replacer-wide latch.
+ *
+ * Evictable frames are kept in a lock-free skiplist (Herlihy-Shavit style, with marked next pointers)
+ * ordered by (class, timestamp, frame id): frames with fewer than k accesses come first, ordered by their
+ * first access, then the others by their k-th most recent access. The global timestamp is an atomic
+ * counter. RecordAccess only takes the latch of its own frame to replace the frame's node, so accesses to
+ * different frames reorder the list in parallel. Evict claims the first node by marking it with a CAS and
+ * then validates the claim under that frame's latch, since the frame may have been requeued or pinned in
+ * between; a stale claim just removes the old node and retries.
+ *
+ * Removed nodes are reclaimed through the EpochManager once they are unlinked from every level.
+ */
+class SkipListLRUKReplacer {
+ public:
+  /**
+   * Constructor for SkipListLRUKReplacer.
+   *
+   * @param num_frames the maximum number of frames the replacer will be required to store
+   * @param k the history length for LRU-K
+   */
+  SkipListLRUKReplacer(size_t num_frames, size_t k);
+
+  DISALLOW_COPY_AND_MOVE(SkipListLRUKReplacer);
+
+  /**
+   * Destroys the replacer and the nodes still linked in the skiplist.
+   */
+  ~SkipListLRUKReplacer();
+
+  /**
+   * Evict the evictable frame with the largest backward k-distance.
+   *
+   * @param[out] frame_id id of frame that is evicted.
+   * @return true if a frame is evicted successfully, false if no frames can be evicted.
+   */
+  auto Evict(frame_id_t *frame_id) -> bool;
+
+  /**
+   * Record the event that the given frame id is accessed at current timestamp.
+   *
+   * @param frame_id id of frame that received a new access.
+   */
+  void RecordAccess(frame_id_t frame_id);
+
+  /**
+   * Toggle whether a frame is evictable or non-evictable.
+   *
+   * @param frame_id id of frame whose 'evictable' status will be modified
+   * @param set_evictable whether the given frame is evictable or not
+   */
+  void SetEvictable(frame_id_t frame_id, bool set_evictable);
+
+  /**
+   * Remove an evictable frame from replacer, along with its access history.
+   *
+   * @param frame_id id of frame to be removed
+   */
+  void Remove(frame_id_t frame_id);
+
+  /**
+   * Return replacer's size, which tracks the number of evictable frames.
+   *
+   * @return size_t
+   */
+  auto Size() -> size_t;
+
+ private:
+  static constexpr int MAX_LEVEL = 16;
+  static constexpr uint64_t HISTORY_CLASS = uint64_t{1} << 63;  // key bit of frames with k accesses
+
+  struct Node {
+    uint64_t key_;
+    frame_id_t frame_id_;
+    int height_;
+    std::atomic<int> linked_levels_;  // levels not yet unlinked (or abandoned); retired when it drops to 0
+    std::atomic<uintptr_t> next_[MAX_LEVEL];  // low bit marks this node as logically deleted at that level
+  };
+
+  /** Per-frame state, guarded by the frame's latch. */
+  struct FrameState {
+    std::mutex latch_;
+    std::vector<size_t> history_;  // the last k access timestamps; access number i is at i % k
+    size_t accesses_{0};
+    bool evictable_{false};
+    Node *node_{nullptr};  // the frame's node while it is evictable
+  };
+
+  static auto IsMarked(uintptr_t link) -> bool { return (link & 1) != 0; }
+  static auto ToNode(uintptr_t link) -> Node * { return reinterpret_cast<Node *>(link & ~static_cast<uintptr_t>(1)); }
+  static auto Less(const Node *node, uint64_t key, frame_id_t frame_id) -> bool {
+    return node->key_ < key || (node->key_ == key && node->frame_id_ < frame_id);
+  }
+
+  /**
+   * @brief Find the predecessors and successors of a key on every level, unlinking marked nodes on the way.
+   * The caller must be pinned.
+   */
+  void Find(uint64_t key, frame_id_t frame_id, Node **preds, Node **succs);
+
+  /** @brief Link a new node for the frame; must hold the frame latch. */
+  auto Insert(frame_id_t frame_id, uint64_t key) -> Node *;
+
+  /** @brief Mark a node as deleted. Returns true for the caller whose CAS on level 0 claimed the node. */
+  auto Claim(Node *node) -> bool;
+
+  /** @brief Account for `levels` levels of a node that are no longer linked, retiring it after the last. */
+  void ReleaseLevels(Node *node, int levels);
+
+  /** @brief Eviction key of a frame, from its access history; must hold the frame latch. */
+  auto KeyOf(const FrameState &frame) const -> uint64_t;
+
+  /** @brief Replace the frame's node with one for its current key; must hold the frame latch. */
+  void Requeue(frame_id_t frame_id);
+
+  size_t replacer_size_;
+  size_t k_;
+  std::atomic<size_t> current_timestamp_{0};
+  std::atomic<size_t> curr_size_{0};
+  std::unique_ptr<FrameState[]> frames_;
+  Node *head_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,96 @@
+#include "buffer/slru_replacer.h"
+
+namespace bustub {
+
+SLRUReplacer::SLRUReplacer(size_t num_frames, size_t protected_size)
+    : replacer_size_(num_frames), protected_size_(protected_size), frames_(num_frames), lists_(num_frames + 2) {}
+
+auto SLRUReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::lock_guard<std::mutex> guard(latch_);
+  size_t sentinel = lists_.IsEmpty(ProbationSentinel()) ? ProtectedSentinel() : ProbationSentinel();
+  if (lists_.IsEmpty(sentinel)) {
+    return false;
+  }
+  size_t victim = lists_.Front(sentinel);
+  lists_.Unlink(victim);
+  FrameState &frame = frames_[victim];
+  if (frame.protected_) {
+    protected_count_--;
+  }
+  frame = FrameState{};
+  curr_size_--;
+  *frame_id = static_cast<frame_id_t>(victim);
+  return true;
+}
+
+void SLRUReplacer::RecordAccess(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  FrameState &frame = frames_[frame_id];
+  if (!frame.tracked_) {
+    // 新页面先进入试用段，此时还未被设置为可驱逐
+    frame.tracked_ = true;
+    return;
+  }
+  if (!frame.protected_) {
+    frame.protected_ = true;
+    protected_count_++;
+  }
+  if (frame.evictable_) {
+    lists_.Unlink(frame_id);
+    lists_.LinkBefore(frame_id, ProtectedSentinel());
+  }
+  Rebalance();
+}
+
+void SLRUReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::lock_guard<std::mutex> guard(latch_);
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  FrameState &frame = frames_[frame_id];
+  if (!frame.tracked_ || frame.evictable_ == set_evictable) {
+    return;
+  }
+  frame.evictable_ = set_evictable;
+  if (set_evictable) {
+    lists_.LinkBefore(frame_id, SegmentOf(frame_id));
+    curr_size_++;
+    // A protected segment that overflowed while all its frames were pinned can shrink now
+    Rebalance();
+  } else {
+    lists_.Unlink(frame_id);
+    curr_size_--;
+  }
+}
+
+void SLRUReplacer::Remove(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  FrameState &frame = frames_[frame_id];
+  if (!frame.tracked_ || !frame.evictable_) {
+    return;
+  }
+  lists_.Unlink(frame_id);
+  if (frame.protected_) {
+    protected_count_--;
+  }
+  frame = FrameState{};
+  curr_size_--;
+}
+
+auto SLRUReplacer::Size() -> size_t {
+  std::lock_guard<std::mutex> guard(latch_);
+  return curr_size_;
+}
+
+void SLRUReplacer::Rebalance() {
+  // 保护段超出容量时，把最久未使用的可驱逐帧降级到试用段的 MRU 端；被 pin 住的帧暂时无法降级
+  while (protected_count_ > protected_size_ && !lists_.IsEmpty(ProtectedSentinel())) {
+    size_t demoted = lists_.Front(ProtectedSentinel());
+    lists_.Unlink(demoted);
+    frames_[demoted].protected_ = false;
+    protected_count_--;
+    lists_.LinkBefore(demoted, ProbationSentinel());
+  }
+}
+
+}  // namespace bustub
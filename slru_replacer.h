@@ -0,0 +1,122 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// slru_replacer.h
+//
+// Identification: src/include/buffer/slru_replacer.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "buffer/intrusive_lists.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * SLRUReplacer implements the segmented LRU replacement policy.
+ *
+ * Frames start in the probationary segment. A second access promotes a frame to the protected segment,
+ * which holds at most protected_size frames; when it overflows, its least recently used frame is demoted
+ * to the most recently used end of probation. Evict takes the least recently used evictable frame of
+ * probation, and only falls back to the protected segment when probation has none. Pages touched once by a
+ * scan therefore never displace pages that were used twice.
+ *
+ * Both segments are intrusive lists of evictable frames, so every operation is O(1). A pinned frame keeps
+ * its segment and re-enters it at the most recently used end when it becomes evictable again.
+ */
+class SLRUReplacer {
+ public:
+  /**
+   * Constructor for SLRUReplacer.
+   *
+   * @param num_frames the maximum number of frames the SLRUReplacer will be required to store
+   * @param protected_size the maximum number of frames in the protected segment
+   */
+  SLRUReplacer(size_t num_frames, size_t protected_size);
+
+  DISALLOW_COPY_AND_MOVE(SLRUReplacer);
+
+  /**
+   * Destroys the SLRUReplacer.
+   */
+  ~SLRUReplacer() = default;
+
+  /**
+   * Evict the least recently used evictable frame of the probationary segment, or of the protected
+   * segment if probation has no evictable frame.
+   *
+   * @param[out] frame_id id of frame that is evicted.
+   * @return true if a frame is evicted successfully, false if no frames can be evicted.
+   */
+  auto Evict(frame_id_t *frame_id) -> bool;
+
+  /**
+   * Record an access to the given frame. A frame seen for the first time enters probation; an access to a
+   * probationary frame promotes it.
+   *
+   * @param frame_id id of frame that received a new access.
+   */
+  void RecordAccess(frame_id_t frame_id);
+
+  /**
+   * Toggle whether a frame is evictable or non-evictable.
+   *
+   * @param frame_id id of frame whose 'evictable' status will be modified
+   * @param set_evictable whether the given frame is evictable or not
+   */
+  void SetEvictable(frame_id_t frame_id, bool set_evictable);
+
+  /**
+   * Remove an evictable frame from replacer.
+   *
+   * @param frame_id id of frame to be removed
+   */
+  void Remove(frame_id_t frame_id);
+
+  /**
+   * Return replacer's size, which tracks the number of evictable frames.
+   *
+   * @return size_t
+   */
+  auto Size() -> size_t;
+
+ private:
+  /** Per-frame state. */
+  struct FrameState {
+    bool tracked_{false};
+    bool evictable_{false};
+    bool protected_{false};
+  };
+
+  /*****************************************************************
+   * Must acquire latch_ first before calling the below functions. *
+   *****************************************************************/
+
+  auto ProbationSentinel() const -> size_t { return replacer_size_; }
+  auto ProtectedSentinel() const -> size_t { return replacer_size_ + 1; }
+  auto SegmentOf(frame_id_t frame_id) const -> size_t {
+    return frames_[frame_id].protected_ ? ProtectedSentinel() : ProbationSentinel();
+  }
+
+  /** @brief Demote protected frames to probation until the protected segment fits again. */
+  void Rebalance();
+
+  size_t replacer_size_;
+  size_t protected_size_;
+  size_t protected_count_{0};  // protected frames, pinned or not
+  size_t curr_size_{0};
+  std::vector<FrameState> frames_;
+  IntrusiveLists lists_;  // frames, then the probation and protected sentinels; front is least recently used
+  std::mutex latch_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,208 @@
+#include <functional>
+#include <list>
+#include <string>
+
+#include "common/epoch_manager.h"
+#include "container/hash/split_ordered_hash_table.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+template <typename K, typename V>
+SplitOrderedHashTable<K, V>::SplitOrderedHashTable(size_t max_load) : max_load_(max_load) {
+  // Bucket 0's sentinel is the head of the whole list
+  auto *segment = new Link[SEGMENT_SIZE]();
+  segment[0].store(reinterpret_cast<uintptr_t>(new Node(SentinelKey(0), K{}, nullptr)));
+  segments_[0].store(segment);
+}
+
+template <typename K, typename V>
+SplitOrderedHashTable<K, V>::~SplitOrderedHashTable() {
+  Node *node = ToNode(segments_[0].load()[0].load());
+  while (node != nullptr) {
+    Node *next = ToNode(node->next_.load());
+    delete node;
+    node = next;
+  }
+  for (auto &segment : segments_) {
+    delete[] segment.load();
+  }
+}
+
+template <typename K, typename V>
+auto SplitOrderedHashTable<K, V>::Reverse(uint64_t x) -> uint64_t {
+  x = ((x >> 1) & 0x5555555555555555ULL) | ((x & 0x5555555555555555ULL) << 1);
+  x = ((x >> 2) & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+  x = ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((x & 0x0F0F0F0F0F0F0F0FULL) << 4);
+  return __builtin_bswap64(x);
+}
+
+template <typename K, typename V>
+auto SplitOrderedHashTable<K, V>::BucketSlot(size_t bucket) -> Link & {
+  std::atomic<Link *> &segment_ptr = segments_[bucket / SEGMENT_SIZE];
+  Link *segment = segment_ptr.load();
+  if (segment == nullptr) {
+    auto *fresh = new Link[SEGMENT_SIZE]();
+    if (segment_ptr.compare_exchange_strong(segment, fresh)) {
+      segment = fresh;
+    } else {
+      delete[] fresh;
+    }
+  }
+  return segment[bucket % SEGMENT_SIZE];
+}
+
+template <typename K, typename V>
+auto SplitOrderedHashTable<K, V>::GetBucket(size_t bucket) -> Node * {
+  Link &slot = BucketSlot(bucket);
+  uintptr_t sentinel = slot.load();
+  if (sentinel != 0) {
+    return ToNode(sentinel);
+  }
+
+  // 父桶 = 去掉最高位的 1；先确保父桶已初始化，再从父桶哨兵开始插入自己的哨兵
+  size_t parent = bucket & ~(size_t{1} << (63 - __builtin_clzll(bucket)));
+  Node *parent_sentinel = GetBucket(parent);
+
+  uint64_t so_key = SentinelKey(bucket);
+  auto *node = new Node(so_key, K{}, nullptr);
+  Window window;
+  while (true) {
+    if (Search(&parent_sentinel->next_, so_key, K{}, &window)) {
+      // Another thread inserted the sentinel first
+      delete node;
+      node = window.curr_;
+      break;
+    }
+    node->next_.store(reinterpret_cast<uintptr_t>(window.curr_));
+    auto expected = reinterpret_cast<uintptr_t>(window.curr_);
+    if (window.prev_->compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(node))) {
+      break;
+    }
+  }
+  uintptr_t empty = 0;
+  slot.compare_exchange_strong(empty, reinterpret_cast<uintptr_t>(node));
+  return node;
+}
+
+template <typename K, typename V>
+auto SplitOrderedHashTable<K, V>::Search(Link *head, uint64_t so_key, const K &key, Window *window) -> bool {
+  bool sentinel = (so_key & 1) == 0;
+retry:
+  Link *prev = head;
+  Node *curr = ToNode(prev->load());
+  while (true) {
+    if (curr == nullptr) {
+      *window = {prev, nullptr};
+      return false;
+    }
+    uintptr_t next = curr->next_.load();
+    if (IsMarked(next)) {
+      // Help finish a delete: unlink the marked node; whoever unlinks it retires it
+      auto expected = reinterpret_cast<uintptr_t>(curr);
+      if (!prev->compare_exchange_strong(expected, next & ~static_cast<uintptr_t>(1))) {
+        goto retry;
+      }
+      EpochManager::Instance().Retire(curr, DeleteNode);
+      curr = ToNode(next);
+      continue;
+    }
+    if (prev->load() != reinterpret_cast<uintptr_t>(curr)) {
+      goto retry;
+    }
+    if (curr->so_key_ > so_key) {
+      *window = {prev, curr};
+      return false;
+    }
+    if (curr->so_key_ == so_key && (sentinel || curr->key_ == key)) {
+      *window = {prev, curr};
+      return true;
+    }
+    prev = &curr->next_;
+    curr = ToNode(next);
+  }
+}
+
+template <typename K, typename V>
+auto SplitOrderedHashTable<K, V>::Find(const K &key, V &value) -> bool {
+  EpochGuard guard;
+  uint64_t hash = HashKey(key);
+  Node *head = GetBucket(hash & (num_buckets_.load() - 1));
+  Window window;
+  if (!Search(&head->next_, RegularKey(hash), key, &window)) {
+    return false;
+  }
+  value = *window.curr_->value_.load();
+  return true;
+}
+
+template <typename K, typename V>
+void SplitOrderedHashTable<K, V>::Insert(const K &key, const V &value) {
+  EpochGuard guard;
+  uint64_t hash = HashKey(key);
+  uint64_t so_key = RegularKey(hash);
+  Node *head = GetBucket(hash & (num_buckets_.load() - 1));
+  auto *new_value = new V(value);
+  Node *node = nullptr;
+  Window window;
+  while (true) {
+    if (Search(&head->next_, so_key, key, &window)) {
+      V *old_value = window.curr_->value_.exchange(new_value);
+      EpochManager::Instance().Retire(old_value, DeleteValue);
+      if (node != nullptr) {
+        node->value_.store(nullptr);
+        delete node;
+      }
+      return;
+    }
+    if (node == nullptr) {
+      node = new Node(so_key, key, new_value);
+    }
+    node->next_.store(reinterpret_cast<uintptr_t>(window.curr_));
+    auto expected = reinterpret_cast<uintptr_t>(window.curr_);
+    if (window.prev_->compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(node))) {
+      break;
+    }
+  }
+
+  // 平均每桶元素过多时把桶数翻倍；新桶在首次访问时才初始化
+  size_t buckets = num_buckets_.load();
+  if (++size_ / buckets > max_load_ && buckets * 2 <= SEGMENT_SIZE * MAX_SEGMENTS) {
+    num_buckets_.compare_exchange_strong(buckets, buckets * 2);
+  }
+}
+
+template <typename K, typename V>
+auto SplitOrderedHashTable<K, V>::Remove(const K &key) -> bool {
+  EpochGuard guard;
+  uint64_t hash = HashKey(key);
+  uint64_t so_key = RegularKey(hash);
+  Node *head = GetBucket(hash & (num_buckets_.load() - 1));
+  Window window;
+  while (true) {
+    if (!Search(&head->next_, so_key, key, &window)) {
+      return false;
+    }
+    // Logical delete: mark the node's next pointer; the winner of this CAS owns the removal
+    uintptr_t next = window.curr_->next_.load();
+    if (IsMarked(next) || !window.curr_->next_.compare_exchange_strong(next, next | 1)) {
+      continue;
+    }
+    auto expected = reinterpret_cast<uintptr_t>(window.curr_);
+    if (window.prev_->compare_exchange_strong(expected, next)) {
+      EpochManager::Instance().Retire(window.curr_, DeleteNode);
+    } else {
+      // Someone changed prev; a search unlinks (and retires) the marked node
+      Search(&head->next_, so_key, key, &window);
+    }
+    size_--;
+    return true;
+  }
+}
+
+template class SplitOrderedHashTable<page_id_t, Page *>;
+template class SplitOrderedHashTable<int, int>;
+template class SplitOrderedHashTable<int, std::string>;
+template class SplitOrderedHashTable<int, std::list<int>::iterator>;
+
+}  // namespace bustub
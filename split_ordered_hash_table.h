@@ -0,0 +1,147 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// split_ordered_hash_table.h
+//
+// Identification: src/include/container/hash/split_ordered_hash_table.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+/**
+ * split_ordered_hash_table.h
+ *
+ * Implementation of a lock-free hash table using split-ordered lists (Shalev & Shavit)
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+#include "common/macros.h"
+#include "container/hash/hash_mix.h"
+#include "container/hash/hash_table.h"
+
+namespace bustub {
+
+/**
+ * SplitOrderedHashTable is a lock-free hash table.
+ *
+ * All entries live in a single lock-free linked list (Harris/Michael) sorted by the bit-reversed hash
+ * ("split order"). A bucket is just a shortcut pointer to a sentinel node in that list. Doubling the
+ * bucket count therefore never moves entries: a new bucket is initialized lazily, on first use, by
+ * inserting its sentinel between the entries of its parent bucket.
+ *
+ * Values are stored out of line and replaced with an atomic exchange, so an update never exposes a
+ * half-written value. Unlinked nodes and replaced values are reclaimed through the EpochManager.
+ *
+ * @tparam K key type
+ * @tparam V value type
+ */
+template <typename K, typename V>
+class SplitOrderedHashTable : public HashTable<K, V> {
+ public:
+  /**
+   * @brief Create a new SplitOrderedHashTable.
+   * @param max_load average number of entries per bucket before the bucket count doubles
+   */
+  explicit SplitOrderedHashTable(size_t max_load = 2);
+
+  DISALLOW_COPY_AND_MOVE(SplitOrderedHashTable);
+
+  /** Destroys the table. No other thread may be using it. */
+  ~SplitOrderedHashTable() override;
+
+  /**
+   * @brief Get the number of logical buckets.
+   * @return The number of buckets.
+   */
+  auto GetNumBuckets() const -> size_t { return num_buckets_.load(); }
+
+  /**
+   * @brief Get the number of entries in the table.
+   * @return The number of entries.
+   */
+  auto GetSize() const -> size_t { return size_.load(); }
+
+  /**
+   * @brief Find the value associated with the given key.
+   * @param key The key to be searched.
+   * @param[out] value The value associated with the key.
+   * @return True if the key is found, false otherwise.
+   */
+  auto Find(const K &key, V &value) -> bool override;
+
+  /**
+   * @brief Insert the given key-value pair into the hash table.
+   * If a key already exists, the value should be updated.
+   * @param key The key to be inserted.
+   * @param value The value to be inserted.
+   */
+  void Insert(const K &key, const V &value) override;
+
+  /**
+   * @brief Given the key, remove the corresponding key-value pair in the hash table.
+   * @param key The key to be deleted.
+   * @return True if the key exists, false otherwise.
+   */
+  auto Remove(const K &key) -> bool override;
+
+ private:
+  static constexpr size_t SEGMENT_SIZE = 1024;
+  static constexpr size_t MAX_SEGMENTS = 1024;
+
+  struct Node {
+    Node(uint64_t so_key, const K &key, V *value) : so_key_(so_key), key_(key), value_(value) {}
+    ~Node() { delete value_.load(); }
+    inline auto IsSentinel() const -> bool { return (so_key_ & 1) == 0; }
+
+    uint64_t so_key_;
+    K key_;
+    std::atomic<V *> value_;
+    std::atomic<uintptr_t> next_{0};  // low bit marks this node as logically deleted
+  };
+  using Link = std::atomic<uintptr_t>;
+
+  /** A window in the list: *prev_ linked to curr_ when the search finished. */
+  struct Window {
+    Link *prev_;
+    Node *curr_;
+  };
+
+  size_t max_load_;
+  std::atomic<size_t> num_buckets_{2};
+  std::atomic<size_t> size_{0};
+  std::array<std::atomic<Link *>, MAX_SEGMENTS> segments_{};
+
+  static auto Reverse(uint64_t x) -> uint64_t;
+  static auto RegularKey(uint64_t hash) -> uint64_t { return Reverse(hash) | 1; }
+  static auto SentinelKey(uint64_t bucket) -> uint64_t { return Reverse(bucket); }
+  static auto IsMarked(uintptr_t link) -> bool { return (link & 1) != 0; }
+  static auto ToNode(uintptr_t link) -> Node * { return reinterpret_cast<Node *>(link & ~static_cast<uintptr_t>(1)); }
+  static void DeleteNode(void *node) { delete static_cast<Node *>(node); }
+  static void DeleteValue(void *value) { delete static_cast<V *>(value); }
+
+  /*****************************************************************
+   * Must be pinned in the EpochManager before calling the below.   *
+   *****************************************************************/
+
+  /** @brief Get the bucket slot, allocating its segment if needed. */
+  auto BucketSlot(size_t bucket) -> Link &;
+
+  /** @brief Get the sentinel of a bucket, initializing it (and its parents) on first use. */
+  auto GetBucket(size_t bucket) -> Node *;
+
+  /**
+   * @brief Search the list from `head` for a node, unlinking marked nodes on the way.
+   * Sentinels match on so_key alone; regular nodes also compare the key.
+   * @return true if found, with the window pointing at the match; otherwise at the insertion point.
+   */
+  auto Search(Link *head, uint64_t so_key, const K &key, Window *window) -> bool;
+};
+
+}  // namespace bustub
@@ -0,0 +1,133 @@
+#include "buffer/weighted_lru_k_replacer.h"
+
+#include <string>
+#include <utility>
+
+namespace bustub {
+
+template <typename Id>
+WeightedLRUKReplacer<Id>::WeightedLRUKReplacer(size_t k) : k_(k) {
+  BUSTUB_ASSERT(k > 0, "k must be positive");
+}
+
+template <typename Id>
+void WeightedLRUKReplacer<Id>::RecordAccess(const Id &id, size_t weight) {
+  std::lock_guard<std::mutex> guard(latch_);
+  auto [it, inserted] = entries_.try_emplace(id);
+  Entry &entry = it->second;
+  if (inserted) {
+    entry.history_.resize(k_);
+  }
+  if (entry.evictable_) {
+    order_.erase(KeyOf(entry));
+    evictable_bytes_ = evictable_bytes_ - entry.weight_ + weight;
+  }
+  // 对象大小可能随访问变化（例如重新压缩），以最新的为准
+  total_bytes_ = total_bytes_ - entry.weight_ + weight;
+  entry.weight_ = weight;
+  entry.history_[entry.accesses_ % k_] = current_timestamp_++;
+  entry.accesses_++;
+  if (entry.evictable_) {
+    order_.emplace(KeyOf(entry), id);
+  }
+}
+
+template <typename Id>
+void WeightedLRUKReplacer<Id>::SetEvictable(const Id &id, bool set_evictable) {
+  std::lock_guard<std::mutex> guard(latch_);
+  auto it = entries_.find(id);
+  if (it == entries_.end() || it->second.evictable_ == set_evictable) {
+    return;
+  }
+  Entry &entry = it->second;
+  entry.evictable_ = set_evictable;
+  if (set_evictable) {
+    order_.emplace(KeyOf(entry), id);
+    evictable_bytes_ += entry.weight_;
+  } else {
+    order_.erase(KeyOf(entry));
+    evictable_bytes_ -= entry.weight_;
+  }
+}
+
+template <typename Id>
+void WeightedLRUKReplacer<Id>::Remove(const Id &id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  auto it = entries_.find(id);
+  if (it == entries_.end() || !it->second.evictable_) {
+    return;
+  }
+  order_.erase(KeyOf(it->second));
+  evictable_bytes_ -= it->second.weight_;
+  total_bytes_ -= it->second.weight_;
+  entries_.erase(it);
+}
+
+template <typename Id>
+auto WeightedLRUKReplacer<Id>::Evict(Id *id, size_t *weight) -> bool {
+  std::lock_guard<std::mutex> guard(latch_);
+  if (order_.empty()) {
+    return false;
+  }
+  size_t freed = EvictFirst(id);
+  if (weight != nullptr) {
+    *weight = freed;
+  }
+  return true;
+}
+
+template <typename Id>
+auto WeightedLRUKReplacer<Id>::EvictBytes(size_t bytes, std::vector<Id> *ids) -> size_t {
+  std::lock_guard<std::mutex> guard(latch_);
+  size_t freed = 0;
+  while (freed < bytes && !order_.empty()) {
+    Id id;
+    freed += EvictFirst(&id);
+    ids->push_back(std::move(id));
+  }
+  return freed;
+}
+
+template <typename Id>
+auto WeightedLRUKReplacer<Id>::Size() -> size_t {
+  std::lock_guard<std::mutex> guard(latch_);
+  return order_.size();
+}
+
+template <typename Id>
+auto WeightedLRUKReplacer<Id>::GetEvictableBytes() -> size_t {
+  std::lock_guard<std::mutex> guard(latch_);
+  return evictable_bytes_;
+}
+
+template <typename Id>
+auto WeightedLRUKReplacer<Id>::GetTotalBytes() -> size_t {
+  std::lock_guard<std::mutex> guard(latch_);
+  return total_bytes_;
+}
+
+template <typename Id>
+auto WeightedLRUKReplacer<Id>::KeyOf(const Entry &entry) const -> uint64_t {
+  if (entry.accesses_ < k_) {
+    return entry.history_[0];
+  }
+  return HISTORY_CLASS | entry.history_[(entry.accesses_ - k_) % k_];
+}
+
+template <typename Id>
+auto WeightedLRUKReplacer<Id>::EvictFirst(Id *id) -> size_t {
+  auto first = order_.begin();
+  *id = first->second;
+  order_.erase(first);
+  auto it = entries_.find(*id);
+  size_t weight = it->second.weight_;
+  evictable_bytes_ -= weight;
+  total_bytes_ -= weight;
+  entries_.erase(it);
+  return weight;
+}
+
+template class WeightedLRUKReplacer<int>;
+template class WeightedLRUKReplacer<std::string>;
+
+}  // namespace bustub
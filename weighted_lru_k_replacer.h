@@ -0,0 +1,127 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// weighted_lru_k_replacer.h
+//
+// Identification: src/include/buffer/weighted_lru_k_replacer.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * WeightedLRUKReplacer applies the LRU-k policy to entries of different sizes, such as compressed pages or
+ * cached objects, identified by arbitrary hashable ids instead of dense frame ids.
+ *
+ * Every entry carries a byte weight. The order is the same as LRUKReplacer: entries with fewer than k
+ * accesses first, by their first access, then the others by their k-th most recent access. Since every
+ * timestamp belongs to exactly one access, the timestamp alone is a unique key, and the evictable entries
+ * are kept in a std::map from it, so every operation is O(log n). EvictBytes() evicts in that order until
+ * the requested number of bytes is free.
+ *
+ * @tparam Id entry id type, hashable with std::hash
+ */
+template <typename Id>
+class WeightedLRUKReplacer {
+ public:
+  /**
+   * @param k the history length for LRU-K
+   */
+  explicit WeightedLRUKReplacer(size_t k);
+
+  DISALLOW_COPY_AND_MOVE(WeightedLRUKReplacer);
+
+  ~WeightedLRUKReplacer() = default;
+
+  /**
+   * Record an access to an entry, creating it if it is new. New entries are not evictable.
+   *
+   * @param id id of the entry
+   * @param weight current size of the entry in bytes
+   */
+  void RecordAccess(const Id &id, size_t weight);
+
+  /**
+   * Toggle whether an entry is evictable or non-evictable.
+   *
+   * @param id id of the entry
+   * @param set_evictable whether the given entry is evictable or not
+   */
+  void SetEvictable(const Id &id, bool set_evictable);
+
+  /**
+   * Remove an evictable entry from replacer, along with its access history.
+   *
+   * @param id id of the entry
+   */
+  void Remove(const Id &id);
+
+  /**
+   * Evict the evictable entry with the largest backward k-distance.
+   *
+   * @param[out] id id of the evicted entry
+   * @param[out] weight bytes freed, may be nullptr
+   * @return true if an entry is evicted successfully, false if no entry can be evicted.
+   */
+  auto Evict(Id *id, size_t *weight = nullptr) -> bool;
+
+  /**
+   * Evict entries in LRU-K order until at least `bytes` bytes are freed or no evictable entry is left.
+   *
+   * @param bytes number of bytes to free
+   * @param[out] ids the evicted entries are appended here
+   * @return the number of bytes freed
+   */
+  auto EvictBytes(size_t bytes, std::vector<Id> *ids) -> size_t;
+
+  /** @brief Return the number of evictable entries. */
+  auto Size() -> size_t;
+
+  /** @brief Return the total weight of the evictable entries. */
+  auto GetEvictableBytes() -> size_t;
+
+  /** @brief Return the total weight of all tracked entries. */
+  auto GetTotalBytes() -> size_t;
+
+ private:
+  static constexpr uint64_t HISTORY_CLASS = uint64_t{1} << 63;  // key bit of entries with k accesses
+
+  struct Entry {
+    std::vector<size_t> history_;  // the last k access timestamps; access number i is at i % k
+    size_t accesses_{0};
+    size_t weight_{0};
+    bool evictable_{false};
+  };
+
+  /*****************************************************************
+   * Must acquire latch_ first before calling the below functions. *
+   *****************************************************************/
+
+  auto KeyOf(const Entry &entry) const -> uint64_t;
+  /** @brief Evict the first entry of order_, which must not be empty. */
+  auto EvictFirst(Id *id) -> size_t;
+
+  size_t k_;
+  size_t current_timestamp_{0};
+  size_t evictable_bytes_{0};
+  size_t total_bytes_{0};
+  std::unordered_map<Id, Entry> entries_;
+  std::map<uint64_t, Id> order_;  // evictable entries by eviction key
+  std::mutex latch_;
+};
+
+}  // namespace bustub